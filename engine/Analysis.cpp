@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "Analysis.h"
+#include "Endgame.h"
+#include "MoveList.h"
+
+namespace reversi {
+
+namespace {
+
+void sort_best_first(std::vector<MoveScore>& moves)
+{
+    std::stable_sort(moves.begin(), moves.end(),
+                     [](const MoveScore& a, const MoveScore& b) {return a.score > b.score;});
+}
+
+} // namespace
+
+void AnalysisProgress::reset()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    moves.clear();
+}
+
+void AnalysisProgress::set_move(const MoveScore& m)
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    for (auto& old: moves) {
+        if (old.move == m.move) {
+            old = m;
+            return;
+        }
+    }
+    moves.push_back(m);
+}
+
+std::vector<MoveScore> AnalysisProgress::snapshot() const
+{
+    std::vector<MoveScore> res;
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        res = moves;
+    }
+    sort_best_first(res);
+    return res;
+}
+
+AnalysisResult Analysis::run(const Position& pos, const SearchLimits& limits, AnalysisProgress* moves)
+{
+    const Search::Clock::time_point start = Search::Clock::now();
+    
+    AnalysisResult res;
+    if (!pos.has_moves()) {return res;}
+    if (pos.num_empties() <= limits.endgame_empties) {return solve(pos, limits, moves);}
+    
+    const MoveList list (pos.moves());
+    const int workers_count = std::min(threads, list.size());
+    
+    std::vector<std::unique_ptr<Search>> searches;
+    for (int i=0; i<workers_count; ++i) {
+        searches.emplace_back(new Search(tt));
+        searches.back()->begin(limits, start);
+    }
+    
+    if (tt) {tt->new_search();}
+    
+    // Scores of the last completed depth, searched in that order at the next one
+    std::vector<MoveScore> scores (list.size());
+    for (int i=0; i<list.size(); ++i) {scores[i].move = list[i];}
+    
+    const int max_depth = std::min(limits.depth, MAX_DEPTH);
+    
+    for (int depth = 1; depth <= max_depth; ++depth) {
+        std::vector<MoveScore> deeper (scores.size());
+        std::atomic<int> next {0};
+        
+        auto work = [&](Search& s) {
+            for (int i = next++; i < static_cast<int>(scores.size()); i = next++) {
+                s.begin_iteration(depth, scores[i].pv);
+                const int score = s.search_move(pos, scores[i].move, depth, -SCORE_INF, SCORE_INF);
+                if (s.stopped()) {return;}
+                
+                MoveScore& m = deeper[i];
+                m.move = scores[i].move;
+                m.score = score;
+                m.depth = depth;
+                m.pv = s.line();
+                if (moves) {moves->set_move(m);}
+            }
+        };
+        
+        std::vector<std::thread> workers;
+        for (int i=1; i<workers_count; ++i) {
+            workers.emplace_back(work, std::ref(*searches[i]));
+        }
+        work(*searches[0]);
+        for (auto& w: workers) {w.join();}
+        
+        // A depth counts only if every move was searched to it
+        const bool stopped = std::any_of(searches.begin(), searches.end(),
+                                         [](const std::unique_ptr<Search>& s) {return s->stopped();});
+        if (stopped) {break;}
+        
+        sort_best_first(deeper);
+        scores = deeper;
+        res.moves = scores;
+        res.depth = depth;
+        
+        const std::vector<int>& best_line = scores[0].pv;
+        if (limits.progress) {limits.progress->set_iteration(depth, scores[0].score, best_line.data(), best_line.size());}
+        
+        if (depth >= pos.num_empties()) {break;}
+        
+        if (limits.time_ms > 0) {
+            const auto elapsed = Search::Clock::now() - start;
+            if (elapsed * 2 > std::chrono::milliseconds(limits.time_ms)) {break;}
+        }
+    }
+    
+    for (auto& s: searches) {
+        s->finish();
+        res.nodes += s->node_count();
+        res.evals += s->eval_count();
+    }
+    res.time_ms = std::chrono::duration<double, std::milli>(Search::Clock::now() - start).count();
+    return res;
+}
+
+// Every move solved by the endgame solver, one solver per thread
+AnalysisResult Analysis::solve(const Position& pos, const SearchLimits& limits, AnalysisProgress* moves)
+{
+    const Search::Clock::time_point start = Search::Clock::now();
+    
+    const MoveList list (pos.moves());
+    const int workers_count = std::min(threads, list.size());
+    const int empties = pos.num_empties();
+    
+    if (tt) {tt->new_search();}
+    
+    std::vector<MoveScore> scores (list.size());
+    std::vector<std::uint64_t> nodes (workers_count, 0);
+    std::atomic<int> next {0};
+    std::atomic<bool> stopped {false};
+    
+    auto work = [&](const int id) {
+        EndgameSolver solver (tt, limits.stop, limits.progress);
+        
+        for (int i = next++; i < list.size(); i = next++) {
+            const int score = -solver.solve(pos.play(list[i]), -64, 64);
+            if (solver.stopped()) {
+                stopped = true;
+                break;
+            }
+            
+            MoveScore& m = scores[i];
+            m.move = list[i];
+            m.score = score;
+            m.depth = empties;
+            m.exact = true;
+            m.pv.push_back(list[i]);
+            if (moves) {moves->set_move(m);}
+        }
+        
+        // solve() only publishes whole batches of nodes
+        solver.publish_nodes();
+        if (tt) {tt->record(solver.table_stats());}
+        nodes[id] = solver.node_count();
+    };
+    
+    std::vector<std::thread> workers;
+    for (int i=1; i<workers_count; ++i) {workers.emplace_back(work, i);}
+    work(0);
+    for (auto& w: workers) {w.join();}
+    
+    AnalysisResult res;
+    for (const std::uint64_t n: nodes) {res.nodes += n;}
+    
+    if (!stopped) {
+        sort_best_first(scores);
+        res.moves = scores;
+        res.depth = empties;
+        if (limits.progress) {limits.progress->set_iteration(empties, scores[0].score, scores[0].pv.data(), 1);}
+    }
+    res.time_ms = std::chrono::duration<double, std::milli>(Search::Clock::now() - start).count();
+    return res;
+}
+
+} // namespace reversi
@@ -0,0 +1,76 @@
+#ifndef REVERSI_ANALYSIS_HEADER
+#define REVERSI_ANALYSIS_HEADER
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "Position.h"
+#include "Search.h"
+#include "TranspositionTable.h"
+
+namespace reversi {
+
+// Score of one root move at the deepest depth searched for it
+struct MoveScore {
+    int move = -1;
+    int score = -SCORE_INF;   // from the point of view of the side to move
+    int depth = 0;
+    bool exact = false;       // solved: score is the final disc difference
+    std::vector<int> pv;      // the move first
+};
+
+struct AnalysisResult {
+    std::vector<MoveScore> moves;  // every legal move, best first
+    int depth = 0;                 // last depth completed for all of them
+    std::uint64_t nodes = 0;
+    std::uint64_t evals = 0;
+    double time_ms = 0;
+};
+
+/* Scores of the root moves of a running analysis, read by a front end
+ * from another thread. Each move is published as soon as it has been
+ * searched to a new depth, so the scores change one by one. reset()
+ * before the analysis starts */
+class AnalysisProgress {
+public:
+    void reset();
+    void set_move(const MoveScore& m);
+    
+    // The moves scored so far, best first
+    std::vector<MoveScore> snapshot() const;
+    
+private:
+    mutable std::mutex mutex;
+    std::vector<MoveScore> moves;
+};
+
+/* Multi-PV analysis: the score of every legal move instead of the best
+ * move alone. Deepens one ply at a time, and at each depth the threads
+ * take the root moves one by one and search each with a full window,
+ * so every score is exact at its depth, not a bound as in the root
+ * split of ParallelSearch. Each move starts from its own line of the
+ * previous depth, and the threads share the transposition table. With
+ * no more than endgame_empties empty squares every move is solved
+ * exactly instead. It costs about one full window search per move */
+class Analysis {
+    TranspositionTable* tt;
+    int threads;
+    
+public:
+    Analysis(TranspositionTable* table, const int num_threads) noexcept
+        : tt{table}, threads{num_threads < 1 ? 1 : num_threads} {}
+    
+    /* Deepens until limits.depth, the end of the game, limits.time_ms or
+     * limits.stop; the first depth always completes unless stopped.
+     * Nodes and each completed depth go to limits.progress, each scored
+     * move to moves if given. Returns no moves if pos has none */
+    AnalysisResult run(const Position& pos, const SearchLimits& limits, AnalysisProgress* moves = nullptr);
+    
+private:
+    AnalysisResult solve(const Position& pos, const SearchLimits& limits, AnalysisProgress* moves);
+};
+
+} // namespace reversi
+
+#endif // REVERSI_ANALYSIS_HEADER
@@ -0,0 +1,107 @@
+#include <utility>
+
+#include "Board.h"
+
+namespace reversi {
+
+void Board::reset(const Position& p) noexcept
+{
+    pos = p;
+    ply = 0;
+    top = 0;
+    
+    const Bitboard empties = pos.empties();
+    terms[0] = eval_terms(pos.player, empties);
+    terms[1] = eval_terms(pos.opponent, empties);
+}
+
+template <bool Patterns>
+void Board::make(const int sq) noexcept
+{
+    const Bitboard flipped = get_flips(pos.player, pos.opponent, sq);
+    
+    Undo& u = undo[ply++];
+    top = ply;
+    u.flipped = flipped;
+    u.sq = sq;
+    
+    const Bitboard player = pos.player ^ flipped ^ bit(sq);
+    const Bitboard opponent = pos.opponent ^ flipped;
+    
+    if (!Patterns) {
+        u.terms[0] = terms[0];
+        u.terms[1] = terms[1];
+        
+        EvalTerms& me = terms[0];
+        EvalTerms& opp = terms[1];
+        
+        int values = 0;
+        for (Bitboard b = flipped; b; b &= b - 1) {
+            values += SQUARE_VALUES[first_square(b)];
+        }
+        
+        const int n = popcount(flipped);
+        me.discs += n + 1;
+        opp.discs -= n;
+        me.squares += values + SQUARE_VALUES[sq];
+        opp.squares -= values;
+        
+        // Counting the frontier again takes a few shifts, cheaper than tracking its changes
+        const Bitboard frontier = get_neighbours(pos.empties() & ~bit(sq));
+        me.frontier = popcount(player & frontier);
+        opp.frontier = popcount(opponent & frontier);
+        
+        std::swap(terms[0], terms[1]);
+    }
+    
+    pos = Position{opponent, player};
+}
+
+template void Board::make<false>(const int sq) noexcept;
+template void Board::make<true>(const int sq) noexcept;
+
+void Board::make_pass() noexcept
+{
+    Undo& u = undo[ply++];
+    top = ply;
+    u.flipped = 0;
+    u.sq = -1;
+    u.terms[0] = terms[0];
+    u.terms[1] = terms[1];
+    
+    pos = pos.pass();
+    std::swap(terms[0], terms[1]);
+}
+
+template <bool Patterns>
+void Board::unmake() noexcept
+{
+    const Undo& u = undo[--ply];
+    
+    if (u.sq < 0) {
+        pos = pos.pass();
+    }
+    else {
+        pos = Position{pos.opponent ^ u.flipped ^ bit(u.sq), pos.player ^ u.flipped};
+    }
+    if (!Patterns) {
+        terms[0] = u.terms[0];
+        terms[1] = u.terms[1];
+    }
+}
+
+template void Board::unmake<false>() noexcept;
+template void Board::unmake<true>() noexcept;
+
+void Board::redo() noexcept
+{
+    // make() forgets the moves after it, which here are still to be redone
+    const int end = top;
+    const int sq = undo[ply].sq;
+    
+    if (sq < 0) {make_pass();}
+    else {make(sq);}
+    top = end;
+}
+
+} // namespace reversi
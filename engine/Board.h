@@ -0,0 +1,89 @@
+#ifndef REVERSI_BOARD_HEADER
+#define REVERSI_BOARD_HEADER
+
+#include "Evaluation.h"
+#include "Patterns.h"
+#include "Position.h"
+
+namespace reversi {
+
+/* A position that is changed in place by make() and restored by unmake(),
+ * keeping the disc counts, disc-square sums and frontier discs of both
+ * sides up to date. A move adds the values of the played cell and the 
+ * flipped discs only, and unmake() restores the saved terms, so 
+ * evaluate() needs no scan of the board. Moves taken back stay on the
+ * stack until another move is made, so they can be played again with
+ * redo(), which is how the game offers undo and redo.
+ * The search knows for the whole tree which evaluation it uses and calls
+ * the Patterns = true versions of make(), unmake() and evaluate(), which
+ * leave the terms of the heuristic alone, or the false ones, which don't
+ * test for pattern tables. The terms are only right again after reset() */
+class Board {
+public:
+    // Moves and passes that can be undone, more than any game needs
+    static constexpr int MAX_PLIES = 128;
+    
+    explicit Board(const Position& pos = Position::initial()) noexcept {reset(pos);}
+    
+    void reset(const Position& pos) noexcept;
+    
+    const Position& position() const noexcept {return pos;}
+    
+    // Plays sq, which must be legal
+    template <bool Patterns = false>
+    void make(const int sq) noexcept;
+    void make_pass() noexcept;
+    
+    // Takes back the last make() or make_pass()
+    template <bool Patterns = false>
+    void unmake() noexcept;
+    
+    // Plays again the last move taken back, if no move was made since
+    bool can_redo() const noexcept {return ply < top;}
+    void redo() noexcept;
+    
+    int plies() const noexcept {return ply;}
+    
+    // Square played at ply i (0 <= i < plies()), -1 for a pass
+    int move(const int i) const noexcept {return undo[i].sq;}
+    
+    // Terms of the side to move and of the other side
+    const EvalTerms& mine() const noexcept {return terms[0];}
+    const EvalTerms& theirs() const noexcept {return terms[1];}
+    
+    // Evaluates with the pattern tables instead of the heuristic, nullptr for the heuristic
+    void set_patterns(const PatternEvaluator* p) noexcept {patterns = p;}
+    
+    bool has_patterns() const noexcept {return patterns != nullptr;}
+    
+    // Same as evaluate(position()), or patterns->evaluate(position())
+    int evaluate() const noexcept
+    {
+        return patterns ? evaluate<true>() : evaluate<false>();
+    }
+    
+    template <bool Patterns>
+    int evaluate() const noexcept
+    {
+        return Patterns ? patterns->evaluate(pos) : reversi::evaluate(pos, terms[0], terms[1]);
+    }
+    
+private:
+    struct Undo {
+        Bitboard flipped;
+        int sq;            // -1 for a pass
+        EvalTerms terms[2];
+    };
+    
+    Position pos;
+    EvalTerms terms[2];
+    const PatternEvaluator* patterns = nullptr;
+    
+    Undo undo[MAX_PLIES];
+    int ply = 0;
+    int top = 0;  // end of the moves that can be redone
+};
+
+} // namespace reversi
+
+#endif // REVERSI_BOARD_HEADER
@@ -0,0 +1,413 @@
+#include <algorithm>
+
+#include "Endgame.h"
+
+namespace reversi {
+
+namespace {
+
+// Below this many empties the table costs more than it saves
+const int DEEP_EMPTIES = 8;
+
+// Nodes between two looks at the stop flag, and between two progress reports
+const std::uint64_t POLL_NODES = 4096;
+
+// Solved scores live in the same table as heuristic ones under other keys
+const std::uint64_t ENDGAME_KEY = 0xA5F1C3D2E4B68709ULL;
+
+// The four 4x4 quadrants of the board
+const Bitboard QUADRANTS[4] = {0x000000000F0F0F0FULL, 0x00000000F0F0F0F0ULL,
+                               0x0F0F0F0F00000000ULL, 0xF0F0F0F000000000ULL};
+
+inline int quadrant(const int sq) noexcept
+{
+    return (row_of(sq) >= 4 ? 2 : 0) + (col_of(sq) >= 4 ? 1 : 0);
+}
+
+// Empties of the quadrants holding an odd number of them
+inline Bitboard odd_regions(const Bitboard empties) noexcept
+{
+    Bitboard res = 0;
+    for (auto q: QUADRANTS) {
+        if (popcount(empties & q) & 1) {res |= empties & q;}
+    }
+    return res;
+}
+
+inline int score_of(const Bitboard P, const Bitboard O) noexcept
+{
+    return final_score(Position{P, O});
+}
+
+} // namespace
+
+int final_score(const Position& pos) noexcept
+{
+    const int p = popcount(pos.player), o = popcount(pos.opponent);
+    const int empties = NUM_SQUARES - p - o;
+    
+    if (p > o) {return p - o + empties;}
+    else if (p < o) {return p - o - empties;}
+    else {return 0;}
+}
+
+SearchResult EndgameSolver::run(const Position& pos)
+{
+    SearchResult res;
+    res.depth = pos.num_empties();
+    nodes = 1;
+    published = 0;
+    next_poll = POLL_NODES;
+    aborted = false;
+    tt_stats = TTStats{};
+    
+    if (tt) {tt->new_search();}
+    
+    // Try the fastest move first, then null windows on the others
+    Bitboard moves = pos.moves();
+    int alpha = -SCORE_INF;
+    
+    while (moves) {
+        int sq = first_square(moves);
+        int fewest = NUM_SQUARES;
+        for (Bitboard mv = moves; mv; mv &= mv - 1) {
+            const int n = popcount(pos.play(first_square(mv)).moves());
+            if (n < fewest) {
+                fewest = n;
+                sq = first_square(mv);
+            }
+        }
+        moves &= ~bit(sq);
+        
+        const Position child = pos.play(sq);
+        int score;
+        
+        if (res.move < 0) {
+            score = -solve(child, -64, 64);
+        }
+        else {
+            score = -solve(child, -alpha-1, -alpha);
+            if (score > alpha && !aborted) {
+                score = -solve(child, -64, -alpha);
+            }
+        }
+        if (aborted) {break;}
+        
+        if (score > alpha) {
+            alpha = score;
+            res.move = sq;
+            res.score = score;
+            if (progress) {progress->set_iteration(res.depth, score, &sq, 1);}
+        }
+    }
+    
+    if (res.move >= 0) {res.pv.push_back(res.move);}
+    if (tt) {tt->record(tt_stats);}
+    publish_nodes();
+    
+    res.nodes = nodes;
+    return res;
+}
+
+void EndgameSolver::publish_nodes() noexcept
+{
+    if (progress) {progress->add_nodes(nodes - published);}
+    published = nodes;
+}
+
+int EndgameSolver::solve(const Position& pos, const int alpha, const int beta)
+{
+    const int empties = pos.num_empties();
+    
+    if (empties >= DEEP_EMPTIES) {
+        return solve_deep(pos.player, pos.opponent, alpha, beta, false);
+    }
+    else if (empties > 4) {
+        return solve_shallow(pos.player, pos.opponent, alpha, beta, false);
+    }
+    else if (empties == 0) {
+        ++nodes;
+        return score_of(pos.player, pos.opponent);
+    }
+    
+    // Gather the last empties, odd regions first
+    int x[4];
+    int n = 0;
+    const Bitboard e = pos.empties();
+    const Bitboard odd = odd_regions(e);
+    for (Bitboard b = e & odd; b; b &= b - 1) {x[n++] = first_square(b);}
+    for (Bitboard b = e & ~odd; b; b &= b - 1) {x[n++] = first_square(b);}
+    
+    switch (empties) {
+        case 1:
+            ++nodes;
+            return solve_1(pos.player, pos.opponent, x[0]);
+        case 2:
+            return solve_2(pos.player, pos.opponent, alpha, beta, false, x[0], x[1]);
+        case 3:
+            return solve_3(pos.player, pos.opponent, alpha, beta, false, x[0], x[1], x[2]);
+        default:
+            return solve_4(pos.player, pos.opponent, alpha, beta, false, x[0], x[1], x[2], x[3]);
+    }
+}
+
+int EndgameSolver::solve_deep(const Bitboard P, const Bitboard O, int alpha, const int beta, const bool passed)
+{
+    ++nodes;
+    
+    // The last empties count their nodes too, nodes can step over any given value
+    if (nodes >= next_poll) {
+        next_poll = nodes + POLL_NODES;
+        if (stop && stop->load(std::memory_order_relaxed)) {aborted = true;}
+        if (progress) {
+            progress->add_nodes(nodes - published);
+            published = nodes;
+        }
+    }
+    if (aborted) {return 0;}
+    
+    const Bitboard moves = get_moves(P, O);
+    if (!moves) {
+        if (passed) {return score_of(P, O);}
+        return -solve_deep(O, P, -beta, -alpha, true);
+    }
+    
+    const int alpha_orig = alpha;
+    const std::uint64_t key = Position{P, O}.hash() ^ ENDGAME_KEY;
+    const int empties = NUM_SQUARES - popcount(P | O);
+    int hash_move = -1;
+    
+    TTEntry entry;
+    if (tt) {++tt_stats.probes;}
+    if (tt && tt->probe(key, entry)) {
+        ++tt_stats.hits;
+        hash_move = entry.move;
+        
+        if (entry.bound == Bound::exact) {return entry.score;}
+        if (entry.bound == Bound::lower && entry.score >= beta) {return entry.score;}
+        if (entry.bound == Bound::upper && entry.score <= alpha) {return entry.score;}
+    }
+    
+    // Fastest first: the fewer replies a move leaves, the sooner it is tried
+    struct Child {
+        Bitboard P, O;
+        int sq;
+        int cost;
+    };
+    Child children[NUM_SQUARES];
+    int n = 0;
+    
+    for (Bitboard mv = moves; mv; mv &= mv - 1) {
+        const int sq = first_square(mv);
+        const Bitboard flipped = get_flips(P, O, sq);
+        Child& c = children[n++];
+        c.P = O ^ flipped;
+        c.O = P ^ flipped ^ bit(sq);
+        c.sq = sq;
+        c.cost = sq == hash_move ? -1 : popcount(get_moves(c.P, c.O));
+    }
+    std::sort(children, children + n, [](const Child& a, const Child& b) {return a.cost < b.cost;});
+    
+    const bool next_deep = empties - 1 >= DEEP_EMPTIES;
+    int best = -SCORE_INF;
+    int best_move = -1;
+    
+    for (int i=0; i<n; ++i) {
+        const Child& c = children[i];
+        int score;
+        
+        auto child_solve = [&](const int a, const int b) {
+            return next_deep ? -solve_deep(c.P, c.O, -b, -a, false)
+                             : -solve_shallow(c.P, c.O, -b, -a, false);
+        };
+        
+        if (i == 0) {
+            score = child_solve(alpha, beta);
+        }
+        else {
+            score = child_solve(alpha, alpha + 1);
+            if (score > alpha && score < beta && !aborted) {
+                score = child_solve(alpha, beta);
+            }
+        }
+        if (aborted) {return 0;}
+        
+        if (score > best) {
+            best = score;
+            best_move = c.sq;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {break;} // cutoff
+            }
+        }
+    }
+    
+    if (tt) {
+        const Bound bound = best <= alpha_orig ? Bound::upper
+                          : best >= beta ? Bound::lower 
+                          : Bound::exact;
+        ++tt_stats.stores;
+        if (tt->store(key, empties, best, bound, best_move)) {++tt_stats.replacements;}
+    }
+    
+    return best;
+}
+
+int EndgameSolver::solve_shallow(const Bitboard P, const Bitboard O, int alpha, const int beta, const bool passed)
+{
+    ++nodes;
+    
+    const Bitboard empties = ~(P | O);
+    const int n_empties = popcount(empties);
+    
+    if (n_empties == 4) {
+        const Bitboard odd = odd_regions(empties);
+        int x[4];
+        int n = 0;
+        for (Bitboard b = empties & odd; b; b &= b - 1) {x[n++] = first_square(b);}
+        for (Bitboard b = empties & ~odd; b; b &= b - 1) {x[n++] = first_square(b);}
+        --nodes; // counted by solve_4
+        return solve_4(P, O, alpha, beta, passed, x[0], x[1], x[2], x[3]);
+    }
+    
+    // Parity: empties of odd regions first, legality straight from the flips
+    const Bitboard odd = odd_regions(empties);
+    const Bitboard order[2] = {empties & odd, empties & ~odd};
+    int best = -SCORE_INF;
+    
+    for (auto group: order) {
+        for (Bitboard b = group; b; b &= b - 1) {
+            const int sq = first_square(b);
+            const Bitboard flipped = get_flips(P, O, sq);
+            if (!flipped) {continue;}
+            
+            const int score = -solve_shallow(O ^ flipped, P ^ flipped ^ bit(sq), -beta, -alpha, false);
+            if (score > best) {
+                best = score;
+                if (score > alpha) {
+                    alpha = score;
+                    if (alpha >= beta) {return best;} // cutoff
+                }
+            }
+        }
+    }
+    
+    if (best == -SCORE_INF) { // no move
+        if (passed) {return score_of(P, O);}
+        return -solve_shallow(O, P, -beta, -alpha, true);
+    }
+    return best;
+}
+
+int EndgameSolver::solve_4(const Bitboard P, const Bitboard O, int alpha, const int beta, const bool passed,
+                           const int x1, const int x2, const int x3, const int x4)
+{
+    ++nodes;
+    
+    const int x[4] = {x1, x2, x3, x4};
+    int best = -SCORE_INF;
+    
+    for (int i=0; i<4; ++i) {
+        const Bitboard flipped = get_flips(P, O, x[i]);
+        if (!flipped) {continue;}
+        
+        // The other three, in the same order
+        int r[3];
+        for (int j=0, k=0; j<4; ++j) {
+            if (j != i) {r[k++] = x[j];}
+        }
+        
+        const int score = -solve_3(O ^ flipped, P ^ flipped ^ bit(x[i]), -beta, -alpha, false, r[0], r[1], r[2]);
+        if (score > best) {
+            best = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {return best;} // cutoff
+            }
+        }
+    }
+    
+    if (best == -SCORE_INF) { // no move
+        if (passed) {return score_of(P, O);}
+        return -solve_4(O, P, -beta, -alpha, true, x1, x2, x3, x4);
+    }
+    return best;
+}
+
+int EndgameSolver::solve_3(const Bitboard P, const Bitboard O, int alpha, const int beta, const bool passed,
+                           const int x1, const int x2, const int x3)
+{
+    ++nodes;
+    
+    int best = -SCORE_INF;
+    Bitboard flipped;
+    
+    if ((flipped = get_flips(P, O, x1))) {
+        best = -solve_2(O ^ flipped, P ^ flipped ^ bit(x1), -beta, -alpha, false, x2, x3);
+        if (best >= beta) {return best;}
+        alpha = std::max(alpha, best);
+    }
+    if ((flipped = get_flips(P, O, x2))) {
+        const int score = -solve_2(O ^ flipped, P ^ flipped ^ bit(x2), -beta, -alpha, false, x1, x3);
+        if (score >= beta) {return score;}
+        if (score > best) {
+            best = score;
+            alpha = std::max(alpha, best);
+        }
+    }
+    if ((flipped = get_flips(P, O, x3))) {
+        const int score = -solve_2(O ^ flipped, P ^ flipped ^ bit(x3), -beta, -alpha, false, x1, x2);
+        if (score > best) {best = score;}
+    }
+    
+    if (best == -SCORE_INF) { // no move
+        if (passed) {return score_of(P, O);}
+        return -solve_3(O, P, -beta, -alpha, true, x1, x2, x3);
+    }
+    return best;
+}
+
+int EndgameSolver::solve_2(const Bitboard P, const Bitboard O, int alpha, const int beta, const bool passed,
+                           const int x1, const int x2)
+{
+    ++nodes;
+    
+    int best = -SCORE_INF;
+    Bitboard flipped;
+    
+    if ((flipped = get_flips(P, O, x1))) {
+        ++nodes;
+        best = -solve_1(O ^ flipped, P ^ flipped ^ bit(x1), x2);
+        if (best >= beta) {return best;}
+        alpha = std::max(alpha, best);
+    }
+    if ((flipped = get_flips(P, O, x2))) {
+        ++nodes;
+        const int score = -solve_1(O ^ flipped, P ^ flipped ^ bit(x2), x1);
+        if (score > best) {best = score;}
+    }
+    
+    if (best == -SCORE_INF) { // no move
+        if (passed) {return score_of(P, O);}
+        return -solve_2(O, P, -beta, -alpha, true, x1, x2);
+    }
+    return best;
+}
+
+/* Only x is empty. With p discs of the side to move, the opponent 
+ * has 63 - p and the difference before the last move is 2p - 63 */
+int EndgameSolver::solve_1(const Bitboard P, const Bitboard O, const int x)
+{
+    const int diff = 2 * popcount(P) - 63;
+    
+    int n = popcount(get_flips(P, O, x));
+    if (n) {return diff + 1 + 2 * n;}
+    
+    n = popcount(get_flips(O, P, x));
+    if (n) {return diff - 1 - 2 * n;}
+    
+    // Nobody can play the last square, it goes to the winner
+    return diff > 0 ? diff + 1 : diff - 1;
+}
+
+} // namespace reversi
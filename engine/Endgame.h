@@ -0,0 +1,70 @@
+#ifndef REVERSI_ENDGAME_HEADER
+#define REVERSI_ENDGAME_HEADER
+
+#include <atomic>
+#include <cstdint>
+
+#include "Position.h"
+#include "Search.h"
+#include "TranspositionTable.h"
+
+namespace reversi {
+
+// Solves the endgame when this many empty squares or fewer are left
+constexpr int DEFAULT_ENDGAME_EMPTIES = 18;
+
+// Final disc difference of a finished game, empty squares going to the winner
+int final_score(const Position& pos) noexcept;
+
+/* Exact solver for the last empties. Scores are final disc differences
+ * for the side to move, from -64 to 64.
+ * Above 7 empties it searches the moves that leave the opponent the
+ * fewest replies first (fastest first) with null windows and the
+ * transposition table. Below that it skips move generation, tries the
+ * empties of regions with an odd number of them first (parity), and the
+ * last 4, 3, 2 and 1 empties have routines of their own. Progress, if
+ * given, gets the nodes every few thousand and each better root move */
+class EndgameSolver {
+public:
+    explicit EndgameSolver(TranspositionTable* table = nullptr,
+                           const std::atomic<bool>* stop_flag = nullptr,
+                           SearchProgress* progress_report = nullptr) noexcept
+        : tt{table}, stop{stop_flag}, progress{progress_report} {}
+    
+    // Best move and its exact score. Only meaningful if not stopped()
+    SearchResult run(const Position& pos);
+    
+    // Fail-soft exact score within (alpha, beta)
+    int solve(const Position& pos, const int alpha, const int beta);
+    
+    // Adds to the progress the nodes it has not got yet, as run() does at its end
+    void publish_nodes() noexcept;
+    
+    bool stopped() const noexcept {return aborted;}
+    std::uint64_t node_count() const noexcept {return nodes;}
+    const TTStats& table_stats() const noexcept {return tt_stats;}
+    
+private:
+    int solve_deep(const Bitboard P, const Bitboard O, int alpha, const int beta, const bool passed);
+    int solve_shallow(const Bitboard P, const Bitboard O, int alpha, const int beta, const bool passed);
+    int solve_4(const Bitboard P, const Bitboard O, int alpha, const int beta, const bool passed,
+                const int x1, const int x2, const int x3, const int x4);
+    int solve_3(const Bitboard P, const Bitboard O, int alpha, const int beta, const bool passed,
+                const int x1, const int x2, const int x3);
+    int solve_2(const Bitboard P, const Bitboard O, int alpha, const int beta, const bool passed,
+                const int x1, const int x2);
+    int solve_1(const Bitboard P, const Bitboard O, const int x);
+    
+    TranspositionTable* tt;
+    TTStats tt_stats;
+    const std::atomic<bool>* stop;
+    SearchProgress* progress;
+    std::uint64_t nodes = 0;
+    std::uint64_t published = 0;  // nodes already added to progress
+    std::uint64_t next_poll = 0;  // node count of the next look at stop and progress
+    bool aborted = false;
+};
+
+} // namespace reversi
+
+#endif // REVERSI_ENDGAME_HEADER
@@ -0,0 +1,74 @@
+#include "Engine.h"
+
+namespace reversi {
+
+void Engine::set_threads(const int num_threads, const ParallelMode m) noexcept
+{
+    threads = num_threads < 1 ? 1 : num_threads;
+    mode = m;
+}
+
+bool Engine::load_weights(const std::string& path)
+{
+    if (!patterns.load(path)) {return false;}
+    use_patterns = true;
+    return true;
+}
+
+bool Engine::load_probcut(const std::string& path)
+{
+    if (!probcut.load(path)) {return false;}
+    use_probcut = true;
+    return true;
+}
+
+SearchResult Engine::search(const Position& pos, const SearchLimits& limits)
+{
+    SearchLimits lim = limits;
+    if (use_patterns && !lim.patterns) {lim.patterns = &patterns;}
+    if (use_probcut && !lim.probcut) {lim.probcut = &probcut;}
+    
+    tt.reset_stats();
+    ParallelSearch s (&tt, threads, mode);
+    return s.run(pos, lim);
+}
+
+AnalysisResult Engine::analyze(const Position& pos, 
+                               const SearchLimits& limits, 
+                               AnalysisProgress* moves)
+{
+    SearchLimits lim = limits;
+    if (use_patterns && !lim.patterns) {lim.patterns = &patterns;}
+    if (use_probcut && !lim.probcut) {lim.probcut = &probcut;}
+    
+    tt.reset_stats();
+    Analysis a (&tt, threads);
+    return a.run(pos, lim, moves);
+}
+
+SearchResult Engine::monte_carlo(const Position& pos, 
+                                 const SearchLimits& limits, 
+                                 const std::uint64_t max_playouts)
+{
+    if (!mcts) {mcts.reset(new MonteCarloSearch());}
+    return mcts->run(pos, limits, threads, max_playouts);
+}
+
+void Engine::new_game()
+{
+    tt.clear();
+    if (mcts) {mcts->clear();}
+}
+
+SearchResult Engine::play(const Position& pos, const SearchLimits& limits)
+{
+    SearchResult res;
+    res.move = book.lookup(pos);
+    if (res.move >= 0) {
+        res.pv.push_back(res.move);
+        return res;
+    }
+    return search(pos, limits);
+}
+
+} // namespace reversi
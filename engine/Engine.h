@@ -0,0 +1,98 @@
+#ifndef REVERSI_ENGINE_HEADER
+#define REVERSI_ENGINE_HEADER
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "Analysis.h"
+#include "Endgame.h"
+#include "MonteCarlo.h"
+#include "OpeningBook.h"
+#include "ParallelSearch.h"
+#include "Patterns.h"
+#include "ProbCut.h"
+#include "Position.h"
+#include "SearchReport.h"
+#include "TranspositionTable.h"
+
+namespace reversi {
+
+/* The computer player without any user interface: its transposition
+ * table, opening book, Monte Carlo tree and thread settings. Front ends (the Qt game, the
+ * command line tools) keep the game and ask it for moves. search() may 
+ * be called from any thread, but only one search at a time */
+class Engine {
+public:
+    Engine() = default;
+    
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+    
+    // Memory given to the transposition table
+    void set_hash_size(const std::size_t size_mb) {tt.resize(size_mb);}
+    
+    // Threads searching each move and how they share the work
+    void set_threads(const int num_threads, const ParallelMode mode) noexcept;
+    
+    // Opening book file built by tools/book. Returns false if it can't be opened
+    bool open_book(const std::string& path) {return book.open(path);}
+    
+    // Book move for pos, -1 if there is none
+    int book_move(const Position& pos) const noexcept {return book.lookup(pos);}
+    
+    // Pattern evaluation instead of the heuristic one
+    void set_pattern_evaluation(const bool enable) noexcept {use_patterns = enable;}
+    
+    /* Pattern weights trained by tools/train, which also switches to the
+     * pattern evaluation. Returns false if the file can't be loaded */
+    bool load_weights(const std::string& path);
+    
+    /* Multi-ProbCut parameters calibrated by tools/probcut for the
+     * evaluation in use. Returns false if the file can't be loaded */
+    bool load_probcut(const std::string& path);
+    
+    // Best move within limits, searched on all threads
+    SearchResult search(const Position& pos, const SearchLimits& limits);
+    
+    // The book move if there is one, else search()
+    SearchResult play(const Position& pos, const SearchLimits& limits);
+    
+    // Scores of every legal move within limits, searched on all threads (see Analysis)
+    AnalysisResult analyze(const Position& pos, const SearchLimits& limits, AnalysisProgress* moves = nullptr);
+    
+    /* Best move by Monte Carlo tree search on all threads, within the
+     * time and stop flag of limits or max_playouts (see MonteCarloSearch).
+     * The tree is allocated by the first call and kept for the next move */
+    SearchResult monte_carlo(const Position& pos, const SearchLimits& limits,
+                             const std::uint64_t max_playouts = 0);
+    
+    // Playouts and speed of the last monte_carlo()
+    MonteCarloStats monte_carlo_stats() const noexcept {return mcts ? mcts->stats() : MonteCarloStats{};}
+    
+    // Forgets what was learned about the previous game
+    void new_game();
+    
+    // Table usage of the last search
+    TTStats table_stats() const noexcept {return tt.stats();}
+    
+    // Report of res, the result of the last search, with its table usage
+    SearchReport report(const SearchResult& res) const {return make_report(res, tt.stats(), threads);}
+    
+    int num_threads() const noexcept {return threads;}
+    
+private:
+    TranspositionTable tt;
+    OpeningBook book;
+    PatternEvaluator patterns;
+    bool use_patterns = false;
+    ProbCut probcut;
+    bool use_probcut = false;
+    std::unique_ptr<MonteCarloSearch> mcts;
+    int threads = 1;
+    ParallelMode mode = ParallelMode::lazy_smp;
+};
+
+} // namespace reversi
+
+#endif // REVERSI_ENGINE_HEADER
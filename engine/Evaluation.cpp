@@ -0,0 +1,129 @@
+#include <cmath>
+
+#include "Evaluation.h"
+
+namespace reversi {
+
+const int SQUARE_VALUES[NUM_SQUARES] = {20, -3, 11,  8,  8, 11, -3, 20,
+                                        -3, -7, -4,  1,  1, -4, -7, -3,
+                                        11, -4,  2,  2,  2,  2, -4, 11,
+                                         8,  1,  2, -3, -3,  2,  1,  8,
+                                         8,  1,  2, -3, -3,  2,  1,  8,
+                                        11, -4,  2,  2,  2,  2, -4, 11,
+                                        -3, -7, -4,  1,  1, -4, -7, -3,
+                                        20, -3, 11,  8,  8, 11, -3, 20};
+
+namespace {
+
+const Bitboard CORNERS = bit(square(0, 0)) | bit(square(0, 7)) |
+                         bit(square(7, 0)) | bit(square(7, 7));
+
+// Cells touching each corner, in the same order as the corners below
+const int CORNER_SQUARES[4] = {square(0, 0), square(0, 7), square(7, 0), square(7, 7)};
+const Bitboard CORNER_NEIGHBOURS[4] = {
+    bit(square(0, 1)) | bit(square(1, 1)) | bit(square(1, 0)),
+    bit(square(0, 6)) | bit(square(1, 6)) | bit(square(1, 7)),
+    bit(square(7, 1)) | bit(square(6, 1)) | bit(square(6, 0)),
+    bit(square(6, 7)) | bit(square(6, 6)) | bit(square(7, 6))
+};
+
+// Sum of SQUARE_VALUES over the discs of each row, for every way of filling the row
+struct RowValueTable {
+    short values[BOARD_SIZE][256];
+};
+
+RowValueTable make_row_value_table() noexcept
+{
+    RowValueTable table;
+    for (int row=0; row<BOARD_SIZE; ++row) {
+        for (int discs=0; discs<256; ++discs) {
+            int sum = 0;
+            for (int col=0; col<BOARD_SIZE; ++col) {
+                if (discs & (1 << col)) {sum += SQUARE_VALUES[square(row, col)];}
+            }
+            table.values[row][discs] = static_cast<short>(sum);
+        }
+    }
+    return table;
+}
+
+const RowValueTable ROW_VALUES = make_row_value_table();
+
+// 100 * (a - b) scaled by whichever side has more
+inline double ratio(const int mine, const int theirs) noexcept
+{
+    if (mine > theirs) {return (100.0 * mine) / (mine + theirs);}
+    else if (mine < theirs) {return -(100.0 * theirs) / (mine + theirs);}
+    else {return 0;}
+}
+
+} // namespace
+
+int square_values(const Bitboard b) noexcept
+{
+    int res = 0;
+    for (int row=0; row<BOARD_SIZE; ++row) {
+        res += ROW_VALUES.values[row][(b >> (8 * row)) & 0xFF];
+    }
+    return res;
+}
+
+EvalTerms eval_terms(const Bitboard discs, const Bitboard empties) noexcept
+{
+    EvalTerms t;
+    t.discs = popcount(discs);
+    t.squares = square_values(discs);
+    t.frontier = popcount(discs & get_neighbours(empties));
+    return t;
+}
+
+double dynamic_heuristic_evaluation_function(const Position& pos) noexcept
+{
+    const Bitboard empties = pos.empties();
+    return dynamic_heuristic_evaluation_function(pos, 
+                                                 eval_terms(pos.player, empties), 
+                                                 eval_terms(pos.opponent, empties));
+}
+
+double dynamic_heuristic_evaluation_function(const Position& pos, 
+                                             const EvalTerms& mine, 
+                                             const EvalTerms& theirs) noexcept
+{
+    const Bitboard me = pos.player, opp = pos.opponent;
+    
+    // Piece difference, frontier disks and disk squares
+    const double p = ratio(mine.discs, theirs.discs);
+    const double d = mine.squares - theirs.squares;
+    const double f = -ratio(mine.frontier, theirs.frontier);
+    
+    // Corner occupancy
+    const double c = 25 * (popcount(me & CORNERS) - popcount(opp & CORNERS));
+    
+    // Corner closeness
+    int my_tiles = 0, opp_tiles = 0;
+    for (int i=0; i<4; ++i) {
+        if (!((me | opp) & bit(CORNER_SQUARES[i]))) {
+            my_tiles += popcount(me & CORNER_NEIGHBOURS[i]);
+            opp_tiles += popcount(opp & CORNER_NEIGHBOURS[i]);
+        }
+    }
+    const double l = -12.5 * (my_tiles - opp_tiles);
+    
+    // Mobility
+    const double m = ratio(popcount(get_moves(me, opp)), popcount(get_moves(opp, me)));
+    
+    // final weighted score
+    return (10 * p) + (801.724 * c) + (382.026 * l) + (78.922 * m) + (74.396 * f) + (10 * d);
+}
+
+int evaluate(const Position& pos) noexcept
+{
+    return static_cast<int>(std::lround(dynamic_heuristic_evaluation_function(pos)));
+}
+
+int evaluate(const Position& pos, const EvalTerms& me, const EvalTerms& opp) noexcept
+{
+    return static_cast<int>(std::lround(dynamic_heuristic_evaluation_function(pos, me, opp)));
+}
+
+} // namespace reversi
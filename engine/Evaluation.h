@@ -0,0 +1,39 @@
+#ifndef REVERSI_EVALUATION_HEADER
+#define REVERSI_EVALUATION_HEADER
+
+#include "Position.h"
+
+namespace reversi {
+
+// Terms of the evaluation of one side that Board keeps up to date move by move
+struct EvalTerms {
+    int discs = 0;
+    int squares = 0;   // sum of the square values of its discs
+    int frontier = 0;  // discs next to an empty cell
+};
+
+// Value of a disc on each square
+extern const int SQUARE_VALUES[NUM_SQUARES];
+
+// Sum of SQUARE_VALUES over the discs of b
+int square_values(const Bitboard b) noexcept;
+
+// The terms of discs computed from scratch
+EvalTerms eval_terms(const Bitboard discs, const Bitboard empties) noexcept;
+
+/* Heuristic score of pos from the point of view of the side to move.
+ * Source: https://github.com/kartikkukreja/blog-codes/blob/master/src/Heuristic%20Function%20for%20Reversi%20(Othello).cpp */
+double dynamic_heuristic_evaluation_function(const Position& pos) noexcept;
+
+// The same with the terms of the side to move and of the opponent already known
+double dynamic_heuristic_evaluation_function(const Position& pos, 
+                                             const EvalTerms& me, 
+                                             const EvalTerms& opp) noexcept;
+
+// The same scores rounded to an integer, as used by the search
+int evaluate(const Position& pos) noexcept;
+int evaluate(const Position& pos, const EvalTerms& me, const EvalTerms& opp) noexcept;
+
+} // namespace reversi
+
+#endif // REVERSI_EVALUATION_HEADER
@@ -0,0 +1,176 @@
+#include <cctype>
+#include <cstdio>
+
+#include "GameRecord.h"
+
+namespace reversi {
+
+std::string square_name(const int sq)
+{
+    return std::string{static_cast<char>('a' + col_of(sq)), static_cast<char>('1' + row_of(sq))};
+}
+
+int parse_square(const char* name) noexcept
+{
+    const int col = std::tolower(static_cast<unsigned char>(name[0])) - 'a';
+    if (col < 0 || col >= BOARD_SIZE) {return -1;}
+    
+    const int row = name[1] - '1';
+    if (row < 0 || row >= BOARD_SIZE) {return -1;}
+    
+    return square(row, col);
+}
+
+bool parse_board(const std::string& text, Position& pos, bool& white_to_move)
+{
+    if (text.size() < NUM_SQUARES + 1) {return false;}
+    
+    Bitboard black = 0, white = 0;
+    for (int sq=0; sq<NUM_SQUARES; ++sq) {
+        switch (text[sq]) {
+            case 'X': case 'x': case '*': black |= bit(sq); break;
+            case 'O': case 'o':           white |= bit(sq); break;
+            case '-': case '.':           break;
+            default: return false;
+        }
+    }
+    
+    std::size_t i = NUM_SQUARES;
+    while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i]))) {++i;}
+    if (i >= text.size()) {return false;}
+    
+    switch (text[i]) {
+        case 'X': case 'x': case 'B': case 'b': case '*': white_to_move = false; break;
+        case 'O': case 'o': case 'W': case 'w':           white_to_move = true; break;
+        default: return false;
+    }
+    
+    pos = white_to_move ? Position{white, black} : Position{black, white};
+    return true;
+}
+
+std::string board_string(const Position& pos, const bool white_to_move)
+{
+    const Bitboard black = white_to_move ? pos.opponent : pos.player;
+    const Bitboard white = white_to_move ? pos.player : pos.opponent;
+    
+    std::string res (NUM_SQUARES, '-');
+    for (int sq=0; sq<NUM_SQUARES; ++sq) {
+        if (black & bit(sq)) {res[sq] = 'X';}
+        else if (white & bit(sq)) {res[sq] = 'O';}
+    }
+    res += white_to_move ? " O" : " X";
+    return res;
+}
+
+std::vector<Position> GameRecord::positions() const
+{
+    std::vector<Position> res;
+    res.reserve(moves.size());
+    
+    Position pos = Position::initial();
+    for (auto sq: moves) {
+        if (!pos.is_legal(sq)) {pos = pos.pass();}
+        res.push_back(pos);
+        pos = pos.play(sq);
+    }
+    return res;
+}
+
+Position GameRecord::final_position(bool* white_to_move) const
+{
+    Position pos = Position::initial();
+    bool white = false;
+    
+    for (auto sq: moves) {
+        if (!pos.is_legal(sq)) {
+            pos = pos.pass();
+            white = !white;
+        }
+        pos = pos.play(sq);
+        white = !white;
+    }
+    
+    if (white_to_move) {*white_to_move = white;}
+    return pos;
+}
+
+bool GameRecord::is_finished() const
+{
+    const Position pos = final_position();
+    return !pos.has_moves() && !pos.pass().has_moves();
+}
+
+std::string GameRecord::to_string() const
+{
+    std::string res;
+    for (auto sq: moves) {res += square_name(sq);}
+    return res;
+}
+
+bool parse_game(const std::string& transcript, GameRecord& game)
+{
+    game.moves.clear();
+    Position pos = Position::initial();
+    
+    for (std::size_t i=0; i<transcript.size(); ) {
+        if (std::isspace(static_cast<unsigned char>(transcript[i]))) {
+            ++i;
+            continue;
+        }
+        
+        if (i + 1 >= transcript.size()) {return false;}
+        const int sq = parse_square(&transcript[i]);
+        if (sq < 0) {return false;}
+        i += 2;
+        
+        if (!pos.is_legal(sq)) {
+            // Either the side to move passed or the move is wrong
+            if (pos.has_moves()) {return false;}
+            pos = pos.pass();
+            if (!pos.is_legal(sq)) {return false;}
+        }
+        
+        pos = pos.play(sq);
+        game.moves.push_back(sq);
+    }
+    return true;
+}
+
+bool write_record(std::FILE* f, const GameRecord& game)
+{
+    unsigned char buf[1 + NUM_SQUARES];
+    if (game.moves.size() > NUM_SQUARES - 4) {return false;}
+    
+    buf[0] = static_cast<unsigned char>(game.moves.size());
+    for (std::size_t i=0; i<game.moves.size(); ++i) {
+        buf[i + 1] = static_cast<unsigned char>(game.moves[i]);
+    }
+    return std::fwrite(buf, 1, game.moves.size() + 1, f) == game.moves.size() + 1;
+}
+
+bool read_record(std::FILE* f, GameRecord& game)
+{
+    unsigned char buf[NUM_SQUARES];
+    const int n = std::fgetc(f);
+    if (n == EOF || n > NUM_SQUARES - 4) {return false;}
+    if (std::fread(buf, 1, n, f) != static_cast<std::size_t>(n)) {return false;}
+    
+    game.moves.clear();
+    Position pos = Position::initial();
+    
+    for (int i=0; i<n; ++i) {
+        const int sq = buf[i];
+        if (sq >= NUM_SQUARES) {return false;}
+        if (!pos.is_legal(sq)) {
+            if (pos.has_moves()) {return false;}
+            pos = pos.pass();
+            if (!pos.is_legal(sq)) {return false;}
+        }
+        pos = pos.play(sq);
+        game.moves.push_back(sq);
+    }
+    return true;
+}
+
+} // namespace reversi
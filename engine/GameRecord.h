@@ -0,0 +1,57 @@
+#ifndef REVERSI_GAME_RECORD_HEADER
+#define REVERSI_GAME_RECORD_HEADER
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Position.h"
+
+namespace reversi {
+
+// Square in the usual notation: column a-h then row 1-8, "a1" is square 0
+std::string square_name(const int sq);
+
+// Square of a name like "f5" or "F5", -1 if it is not one
+int parse_square(const char* name) noexcept;
+
+/* A board as 64 characters in square order ('X' or '*' Black, 'O' White, 
+ * '-' or '.' empty) followed, after optional blanks, by the side to move 
+ * ('X' or 'B' Black, 'O' or 'W' White). Returns false if text isn't one */
+bool parse_board(const std::string& text, Position& pos, bool& white_to_move);
+
+std::string board_string(const Position& pos, const bool white_to_move);
+
+/* A game as the squares played from the initial position, Black first.
+ * Passes are not written down: when the side to move has no move the
+ * next square belongs to the other side */
+struct GameRecord {
+    std::vector<int> moves;
+    
+    // Position before each move, seen from the side about to play
+    std::vector<Position> positions() const;
+    
+    // Position after the last move, with the side to move (false is Black)
+    Position final_position(bool* white_to_move = nullptr) const;
+    
+    // No more moves for either side
+    bool is_finished() const;
+    
+    std::string to_string() const;
+};
+
+/* Reads a transcript like "f5d6c3d3c4..." (spaces allowed between moves).
+ * Returns false if a square is malformed or an illegal move is played */
+bool parse_game(const std::string& transcript, GameRecord& game);
+
+/* Compact records, for files of many games: the number of moves in one
+ * byte, then one byte per square. Passes are implicit as in transcripts */
+bool write_record(std::FILE* f, const GameRecord& game);
+
+/* Reads the next record of f. Returns false at the end of the file or if
+ * the record is damaged (a square off the board or an illegal move) */
+bool read_record(std::FILE* f, GameRecord& game);
+
+} // namespace reversi
+
+#endif // REVERSI_GAME_RECORD_HEADER
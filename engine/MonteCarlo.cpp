@@ -0,0 +1,425 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "Endgame.h"
+#include "MonteCarlo.h"
+
+namespace reversi {
+
+namespace {
+
+enum NodeState : std::uint8_t {
+    NODE_NEW = 0, NODE_BUSY, NODE_EXPANDED
+};
+
+constexpr std::uint32_t NO_NODE = 0xFFFFFFFF;
+
+// Exploration constant of UCT, for win rates between 0 and 1
+constexpr double UCT_C = 0.7;
+
+// Visits without a win that a playout on its way counts for
+constexpr std::uint32_t VIRTUAL_LOSS = 1;
+
+// The main thread looks at the clock and publishes its line this often
+constexpr std::uint64_t CLOCK_PLAYOUTS = 16;
+constexpr std::uint64_t LINE_PLAYOUTS = 4096;
+
+// Playouts counted by a thread before it adds them to the progress, and to the
+// total when the playouts are not limited
+constexpr std::uint64_t PUBLISH_PLAYOUTS = 256;
+
+inline std::uint64_t next_random(std::uint64_t& state) noexcept
+{
+    // xorshift64*
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+/* Random moves to the end of the game. Returns the final disc difference
+ * for the side to move in pos */
+int random_playout(Position pos, std::uint64_t& rng) noexcept
+{
+    int sign = 1;
+    
+    while (true) {
+        Bitboard moves = pos.moves();
+        if (!moves) {
+            pos = pos.pass();
+            sign = -sign;
+            if (!pos.has_moves()) {break;}
+            continue;
+        }
+        
+        for (int n = next_random(rng) % popcount(moves); n > 0; --n) {moves &= moves - 1;}
+        pos = pos.play(first_square(moves));
+        sign = -sign;
+    }
+    return sign * final_score(pos);
+}
+
+} // namespace
+
+MonteCarloSearch::MonteCarloSearch(const std::size_t size_mb)
+{
+    const std::size_t bytes = std::max<std::size_t>(size_mb, 1) << 20;
+    pool_size = std::min<std::size_t>(bytes / 2 / sizeof(Node), NO_NODE / 2);
+    
+    pools[0].reset(new Node[pool_size]);
+    pools[1].reset(new Node[pool_size]);
+}
+
+void MonteCarloSearch::clear() noexcept
+{
+    has_tree = false;
+    used = 0;
+}
+
+SearchResult MonteCarloSearch::run(const Position& pos,
+                                   const SearchLimits& limits,
+                                   const int threads,
+                                   const std::uint64_t playout_limit)
+{
+    const Clock::time_point start = Clock::now();
+    
+    SearchResult res;
+    if (!pos.has_moves()) {return res;}
+    
+    if (!reuse(pos)) {new_tree(pos);}
+    
+    MonteCarloStats st;
+    st.threads = std::max(threads, 1);
+    st.reused = pools[current][0].visits.load();
+    
+    total_playouts = 0;
+    max_playouts = playout_limit;
+    timed = limits.time_ms > 0 || playout_limit == 0;
+    deadline = start + std::chrono::milliseconds(limits.time_ms > 0 || playout_limit > 0 ? limits.time_ms : 1000);
+    stop = limits.stop;
+    ++searches;
+    
+    std::atomic<bool> done {false};
+    std::vector<std::thread> workers;
+    for (int i=1; i<st.threads; ++i) {
+        workers.emplace_back(&MonteCarloSearch::playouts, this, std::cref(pos), std::ref(done),
+                             searches * 64 + i, limits.progress, false);
+    }
+    playouts(pos, done, searches * 64, limits.progress, true);
+    for (auto& w: workers) {w.join();}
+    
+    int line[MAX_DEPTH + 1];
+    const int length = principal_line(line);
+    res.pv.assign(line, line + length);
+    res.move = length > 0 ? line[0] : first_square(pos.moves());
+    res.depth = length;
+    
+    const Node* tree = pools[current].get();
+    const int best = best_child(tree[0]);
+    if (best >= 0) {
+        const Node& child = tree[tree[0].first_child + best];
+        const std::uint32_t visits = child.visits.load();
+        if (visits > 0) {res.score = static_cast<int>(std::lround(1000.0 * child.wins.load() / visits - 1000));}
+    }
+    
+    res.nodes = total_playouts;
+    res.time_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    
+    st.playouts = total_playouts;
+    st.seconds = res.time_ms / 1000;
+    st.tree_nodes = std::min<std::size_t>(used.load(), pool_size);
+    last_stats = st;
+    return res;
+}
+
+bool MonteCarloSearch::out_of_budget() const noexcept
+{
+    if (stop && stop->load(std::memory_order_relaxed)) {return true;}
+    return timed && Clock::now() >= deadline;
+}
+
+void MonteCarloSearch::playouts(const Position& pos,
+                                std::atomic<bool>& done,
+                                std::uint64_t seed,
+                                SearchProgress* progress,
+                                const bool main_thread)
+{
+    Node* const tree = pools[current].get();
+    
+    // splitmix64 of the seed, never 0 for xorshift
+    seed += 0x9E3779B97F4A7C15ULL;
+    seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+    std::uint64_t rng = (seed ^ (seed >> 31)) | 1;
+    
+    Path path;
+    std::uint64_t count = 0, published = 0;
+    
+    // A limit is kept exactly: each playout takes its place in the total before it is played
+    const bool limited = max_playouts > 0;
+    
+    // Some thread plays at least one playout, so there is a move to return
+    do {
+        if (limited && total_playouts.fetch_add(1, std::memory_order_relaxed) >= max_playouts) {
+            total_playouts.fetch_sub(1, std::memory_order_relaxed);
+            done = true;
+            break;
+        }
+        
+        // Down to a leaf, adding a virtual loss to every node of the path
+        Position p = pos;
+        std::uint32_t index = 0;
+        path.length = 0;
+        
+        while (true) {
+            Node& node = tree[index];
+            node.pending.fetch_add(1, std::memory_order_relaxed);
+            path.nodes[path.length++] = index;
+            
+            // A leaf is expanded on its second visit. Nodes being expanded by another thread are leaves meanwhile
+            if (node.state.load(std::memory_order_acquire) != NODE_EXPANDED) {
+                if ((index != 0 && node.visits.load(std::memory_order_relaxed) == 0) || !expand(node, p)) {break;}
+            }
+            if (node.num_children == 0) {break;}  // the game is over
+            
+            index = node.first_child + select(node);
+            const int move = tree[index].move;
+            p = move < 0 ? p.pass() : p.play(move);
+        }
+        
+        backup(path, random_playout(p, rng));
+        ++count;
+        
+        if (count - published == PUBLISH_PLAYOUTS) {
+            if (!limited) {total_playouts.fetch_add(count - published, std::memory_order_relaxed);}
+            if (progress) {progress->add_nodes(count - published);}
+            published = count;
+        }
+        
+        if (main_thread) {
+            if (count % CLOCK_PLAYOUTS == 1 && out_of_budget()) {done = true;}
+            if (progress && count % LINE_PLAYOUTS == 0) {
+                int line[MAX_DEPTH + 1];
+                const int length = principal_line(line);
+                progress->set_iteration(length, 0, line, length);
+            }
+        }
+    } while (!done.load(std::memory_order_relaxed));
+    
+    if (!limited) {total_playouts.fetch_add(count - published, std::memory_order_relaxed);}
+    if (progress) {progress->add_nodes(count - published);}
+}
+
+/* Gives node its children, or none if the game is over. Returns false if
+ * it has no children afterwards: the game is over, another thread is
+ * expanding it, or the pool is full */
+bool MonteCarloSearch::expand(Node& node, const Position& pos) noexcept
+{
+    std::uint8_t expected = NODE_NEW;
+    if (!node.state.compare_exchange_strong(expected, NODE_BUSY, std::memory_order_acq_rel)) {return false;}
+    
+    Bitboard moves = pos.moves();
+    const int count = moves ? popcount(moves) : pos.pass().has_moves() ? 1 : 0;
+    
+    std::uint32_t first = 0;
+    if (count > 0) {
+        first = allocate(count);
+        if (first == NO_NODE) {
+            node.state.store(NODE_NEW, std::memory_order_release);
+            return false;
+        }
+        
+        // Nobody sees the children before the release below
+        Node* const children = pools[current].get() + first;
+        for (int i=0; i<count; ++i) {
+            Node& c = children[i];
+            c.visits.store(0, std::memory_order_relaxed);
+            c.wins.store(0, std::memory_order_relaxed);
+            c.pending.store(0, std::memory_order_relaxed);
+            c.state.store(NODE_NEW, std::memory_order_relaxed);
+            c.first_child = 0;
+            c.num_children = 0;
+            c.move = moves ? static_cast<std::int8_t>(first_square(moves)) : -1;
+            moves &= moves - 1;
+        }
+    }
+    
+    node.first_child = first;
+    node.num_children = static_cast<std::uint8_t>(count);
+    node.state.store(NODE_EXPANDED, std::memory_order_release);
+    return count > 0;
+}
+
+// Index among the children of node with the best upper confidence bound, unvisited ones first
+std::uint32_t MonteCarloSearch::select(const Node& node) const noexcept
+{
+    const Node* const children = pools[current].get() + node.first_child;
+    const double log_visits = std::log(static_cast<double>(node.visits.load(std::memory_order_relaxed) +
+                                                           node.pending.load(std::memory_order_relaxed)));
+    
+    std::uint32_t best = 0;
+    double best_bound = -1;
+    
+    for (int i=0; i<node.num_children; ++i) {
+        const Node& c = children[i];
+        const std::uint32_t n = c.visits.load(std::memory_order_relaxed) +
+                                VIRTUAL_LOSS * c.pending.load(std::memory_order_relaxed);
+        if (n == 0) {return i;}
+        
+        const double bound = c.wins.load(std::memory_order_relaxed) / (2.0 * n) + UCT_C * std::sqrt(log_visits / n);
+        if (bound > best_bound) {
+            best_bound = bound;
+            best = i;
+        }
+    }
+    return best;
+}
+
+/* result is the final disc difference for the side to move after the
+ * path, which is not the side that moved into its last node */
+void MonteCarloSearch::backup(const Path& path, int result) noexcept
+{
+    Node* const tree = pools[current].get();
+    
+    for (int i = path.length - 1; i >= 0; --i) {
+        Node& node = tree[path.nodes[i]];
+        node.wins.fetch_add(result < 0 ? 2 : result == 0 ? 1 : 0, std::memory_order_relaxed);
+        node.visits.fetch_add(1, std::memory_order_relaxed);
+        node.pending.fetch_sub(1, std::memory_order_relaxed);
+        result = -result;
+    }
+}
+
+// First of count consecutive nodes, NO_NODE if the pool has no room left
+std::uint32_t MonteCarloSearch::allocate(const int count) noexcept
+{
+    // Checked first so that failed claims don't push used far past the end
+    if (used.load(std::memory_order_relaxed) + count > pool_size) {return NO_NODE;}
+    
+    const std::uint32_t first = used.fetch_add(count, std::memory_order_relaxed);
+    return first + count <= pool_size ? first : NO_NODE;
+}
+
+void MonteCarloSearch::new_tree(const Position& pos) noexcept
+{
+    Node& root = pools[current][0];
+    root.visits = 0;
+    root.wins = 0;
+    root.pending = 0;
+    root.state = NODE_NEW;
+    root.first_child = 0;
+    root.num_children = 0;
+    root.move = -1;
+    
+    used = 1;
+    root_pos = pos;
+    has_tree = true;
+}
+
+/* Keeps the subtree of pos if it is the root of the previous search or
+ * one of its children or grandchildren */
+bool MonteCarloSearch::reuse(const Position& pos) noexcept
+{
+    if (!has_tree) {return false;}
+    if (pos == root_pos) {return true;}
+    
+    const Node* const tree = pools[current].get();
+    const Node& root = tree[0];
+    if (root.state != NODE_EXPANDED) {return false;}
+    
+    for (int i=0; i<root.num_children; ++i) {
+        const std::uint32_t c = root.first_child + i;
+        const Position child = tree[c].move < 0 ? root_pos.pass() : root_pos.play(tree[c].move);
+        if (child == pos) {
+            copy_subtree(c);
+            root_pos = pos;
+            return true;
+        }
+        
+        if (tree[c].state != NODE_EXPANDED) {continue;}
+        for (int j=0; j<tree[c].num_children; ++j) {
+            const std::uint32_t g = tree[c].first_child + j;
+            const Position grandchild = tree[g].move < 0 ? child.pass() : child.play(tree[g].move);
+            if (grandchild == pos) {
+                copy_subtree(g);
+                root_pos = pos;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* Copies the subtree of from breadth first to the other pool, which
+ * becomes the current one. Each block of children stays in one piece */
+void MonteCarloSearch::copy_subtree(const std::uint32_t from) noexcept
+{
+    const Node* const src = pools[current].get();
+    Node* const dst = pools[1 - current].get();
+    
+    // Until a copied node is visited by the loop below its first_child still points into src
+    auto copy = [](Node& d, const Node& s) {
+        d.visits.store(s.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        d.wins.store(s.wins.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        d.pending.store(0, std::memory_order_relaxed);
+        d.state.store(s.state.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        d.first_child = s.first_child;
+        d.num_children = s.num_children;
+        d.move = s.move;
+    };
+    
+    copy(dst[0], src[from]);
+    std::uint32_t next = 1;
+    
+    for (std::uint32_t i=0; i<next; ++i) {
+        Node& d = dst[i];
+        if (d.state.load(std::memory_order_relaxed) != NODE_EXPANDED) {continue;}
+        
+        const std::uint32_t children = d.first_child;
+        d.first_child = next;
+        for (int c=0; c<d.num_children; ++c) {copy(dst[next + c], src[children + c]);}
+        next += d.num_children;
+    }
+    
+    current = 1 - current;
+    used = next;
+}
+
+// Index of the most visited child of node, -1 if it has none
+int MonteCarloSearch::best_child(const Node& node) const noexcept
+{
+    if (node.state.load(std::memory_order_acquire) != NODE_EXPANDED) {return -1;}
+    
+    const Node* const children = pools[current].get() + node.first_child;
+    int best = -1;
+    std::uint32_t most = 0;
+    
+    for (int i=0; i<node.num_children; ++i) {
+        const std::uint32_t v = children[i].visits.load(std::memory_order_relaxed);
+        if (v > most) {
+            most = v;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Most visited line from the root, as long as it has been visited. Returns its length
+int MonteCarloSearch::principal_line(int* line) const noexcept
+{
+    const Node* const tree = pools[current].get();
+    const Node* node = &tree[0];
+    int length = 0;
+    
+    while (length <= MAX_DEPTH) {
+        const int best = best_child(*node);
+        if (best < 0) {break;}
+        node = &tree[node->first_child + best];
+        line[length++] = node->move;
+    }
+    return length;
+}
+
+} // namespace reversi
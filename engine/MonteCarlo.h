@@ -0,0 +1,125 @@
+#ifndef REVERSI_MONTE_CARLO_HEADER
+#define REVERSI_MONTE_CARLO_HEADER
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Position.h"
+#include "Search.h"
+
+namespace reversi {
+
+// Memory of the node pools of a Monte Carlo search
+constexpr std::size_t DEFAULT_MONTE_CARLO_MB = 64;
+
+struct MonteCarloStats {
+    std::uint64_t playouts = 0;
+    std::uint64_t reused = 0;     // visits of the subtree kept from the previous search
+    std::size_t tree_nodes = 0;   // in the pool at the end of the search
+    double seconds = 0;
+    int threads = 1;
+    
+    double playouts_per_second() const noexcept {return seconds > 0 ? playouts / seconds : 0.0;}
+    
+    // The figure to tune: threads waiting on each other or on memory lower it
+    double playouts_per_second_per_core() const noexcept {return playouts_per_second() / threads;}
+};
+
+/* Monte Carlo tree search with UCT: each playout walks down the tree
+ * choosing the child with the best upper confidence bound, expands the
+ * leaf it reaches if it was visited before, plays random moves to the
+ * end of the game and counts the result in every node of the path.
+ * Threads share one tree. A thread going down a node adds a virtual
+ * loss to it until its result comes back, so the other threads see the
+ * line as worse and spread over other ones instead of all following it.
+ * Nodes come from a pool allocated once: the children of a node are a
+ * block of consecutive nodes, claimed with one atomic add. When the
+ * pool is full the tree stops growing and playouts start at the leaves.
+ * The tree is kept between searches: if the new position is a child or
+ * grandchild of the previous root (the reply to the last move), that
+ * subtree and its statistics are copied to the second pool, which
+ * becomes the current one, and the rest is dropped.
+ * The move played is the most visited one. SearchResult::score is its
+ * win rate as a score from -1000 (always lost) to 1000, nodes counts
+ * the playouts and pv follows the most visited children */
+class MonteCarloSearch {
+public:
+    explicit MonteCarloSearch(const std::size_t size_mb = DEFAULT_MONTE_CARLO_MB);
+    
+    MonteCarloSearch(const MonteCarloSearch&) = delete;
+    MonteCarloSearch& operator=(const MonteCarloSearch&) = delete;
+    
+    /* Searches until limits.time_ms have passed, max_playouts playouts
+     * were played or limits.stop is set, whichever comes first. The
+     * depth limit does not apply. Without time or playout limits it
+     * searches for one second. Nodes go to limits.progress if set */
+    SearchResult run(const Position& pos, const SearchLimits& limits, const int threads,
+                     const std::uint64_t max_playouts = 0);
+    
+    // Forgets the tree, for a new game
+    void clear() noexcept;
+    
+    const MonteCarloStats& stats() const noexcept {return last_stats;}
+    
+    std::size_t capacity() const noexcept {return pool_size;}
+    
+private:
+    struct Node {
+        std::atomic<std::uint32_t> visits {0};
+        std::atomic<std::uint32_t> wins {0};     // half points of the side that moved into the node
+        std::atomic<std::uint32_t> pending {0};  // playouts gone through, result not back yet
+        std::uint32_t first_child = 0;
+        std::atomic<std::uint8_t> state {0};     // new, being expanded or expanded
+        std::uint8_t num_children = 0;
+        std::int8_t move = -1;                   // square played to reach it, -1 for a pass
+    };
+    
+    // Path of one playout through the tree, root first
+    struct Path {
+        std::uint32_t nodes[2 * NUM_SQUARES + 2];
+        int length = 0;
+    };
+    
+    using Clock = std::chrono::steady_clock;
+    
+    void playouts(const Position& pos, std::atomic<bool>& done, std::uint64_t seed,
+                  SearchProgress* progress, const bool main_thread);
+    bool out_of_budget() const noexcept;
+    bool expand(Node& node, const Position& pos) noexcept;
+    std::uint32_t select(const Node& node) const noexcept;
+    void backup(const Path& path, int result) noexcept;
+    
+    std::uint32_t allocate(const int count) noexcept;
+    bool reuse(const Position& pos) noexcept;
+    void copy_subtree(const std::uint32_t from) noexcept;
+    void new_tree(const Position& pos) noexcept;
+    
+    int best_child(const Node& node) const noexcept;
+    int principal_line(int* line) const noexcept;
+    
+    // Two pools: the current tree, and room to copy the part of it kept for the next search
+    std::unique_ptr<Node[]> pools[2];
+    std::size_t pool_size = 0;
+    int current = 0;
+    std::atomic<std::uint32_t> used {0};
+    
+    Position root_pos;
+    bool has_tree = false;
+    
+    // Budget of the running search
+    std::atomic<std::uint64_t> total_playouts {0};
+    std::uint64_t max_playouts = 0;
+    Clock::time_point deadline;
+    bool timed = false;
+    const std::atomic<bool>* stop = nullptr;
+    
+    std::uint64_t searches = 0;  // seeds the random playouts, so a search can be repeated
+    MonteCarloStats last_stats;
+};
+
+} // namespace reversi
+
+#endif // REVERSI_MONTE_CARLO_HEADER
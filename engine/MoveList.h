@@ -0,0 +1,79 @@
+#ifndef REVERSI_MOVE_LIST_HEADER
+#define REVERSI_MOVE_LIST_HEADER
+
+#include <algorithm>
+#include <cstdint>
+
+#include "Position.h"
+
+namespace reversi {
+
+/* The squares of a set of moves in an array of fixed size, so that the
+ * search can order them at every node without allocating. One byte per
+ * square of the board: no position, even one typed in by hand, has more
+ * moves than that. Moves start in raster order, and can be sorted by
+ * scores given to them */
+class MoveList {
+public:
+    MoveList() noexcept = default;
+    
+    explicit MoveList(Bitboard moves) noexcept
+    {
+        for (; moves; moves &= moves - 1) {
+            squares[count++] = static_cast<std::uint8_t>(first_square(moves));
+        }
+    }
+    
+    int size() const noexcept {return count;}
+    bool empty() const noexcept {return count == 0;}
+    int operator[](const int i) const noexcept {return squares[i];}
+    
+    const std::uint8_t* begin() const noexcept {return squares;}
+    const std::uint8_t* end() const noexcept {return squares + count;}
+    
+    void push_back(const int sq) noexcept {squares[count++] = static_cast<std::uint8_t>(sq);}
+    
+    void set_score(const int i, const int score) noexcept {scores[i] = score;}
+    
+    // Best score first, equal scores keeping their order
+    void sort() noexcept
+    {
+        for (int i=1; i<count; ++i) {
+            const std::uint8_t sq = squares[i];
+            const int score = scores[i];
+            int j = i;
+            for (; j > 0 && scores[j-1] < score; --j) {
+                squares[j] = squares[j-1];
+                scores[j] = scores[j-1];
+            }
+            squares[j] = sq;
+            scores[j] = score;
+        }
+    }
+    
+    // Puts sq first, the other moves keeping their order. Nothing happens if sq is not in the list
+    void move_to_front(const int sq) noexcept
+    {
+        std::uint8_t* const it = std::find(squares, squares + count, static_cast<std::uint8_t>(sq));
+        if (sq >= 0 && it != squares + count) {std::rotate(squares, it, it + 1);}
+    }
+    
+    /* The moves after the first one from square sq on, then the ones
+     * before sq, both in the order they were in */
+    void rotate_from(const int sq) noexcept
+    {
+        if (count < 2) {return;}
+        std::uint8_t* const it = std::find_if(squares + 1, squares + count,
+                                              [sq](const std::uint8_t s) {return s >= sq;});
+        std::rotate(squares + 1, it, squares + count);
+    }
+
+private:
+    std::uint8_t squares[NUM_SQUARES];
+    int scores[NUM_SQUARES];
+    int count = 0;
+};
+
+} // namespace reversi
+
+#endif // REVERSI_MOVE_LIST_HEADER
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "OpeningBook.h"
+
+namespace reversi {
+
+namespace {
+
+struct BookHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t count;
+};
+
+static_assert(sizeof(BookHeader) == 16, "BookHeader is written to disk as is");
+
+const char BOOK_MAGIC[4] = {'R', 'V', 'B', 'K'};
+const std::uint32_t BOOK_VERSION = 1;
+
+inline bool entry_less(const BookEntry& a, const BookEntry& b) noexcept
+{
+    return Position{a.player, a.opponent} < Position{b.player, b.opponent};
+}
+
+} // namespace
+
+bool OpeningBook::open(const std::string& path)
+{
+    close();
+    
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {return false;}
+    
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(BookHeader)) {
+        ::close(fd);
+        return false;
+    }
+    
+    map_size = st.st_size;
+    void* addr = ::mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps the file alive
+    
+    if (addr == MAP_FAILED) {
+        map_size = 0;
+        return false;
+    }
+    map = addr;
+    
+    // The count comes from the file: divide the size rather than multiply it, which could wrap
+    const BookHeader* header = static_cast<const BookHeader*>(map);
+    const std::size_t body = map_size - sizeof(BookHeader);
+    if (std::memcmp(header->magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 ||
+        header->version != BOOK_VERSION ||
+        body % sizeof(BookEntry) != 0 ||
+        header->count != body / sizeof(BookEntry)) 
+    {
+        close();
+        return false;
+    }
+    
+    entries = reinterpret_cast<const BookEntry*>(header + 1);
+    count = header->count;
+    return true;
+}
+
+void OpeningBook::close() noexcept
+{
+    if (map) {::munmap(map, map_size);}
+    
+    map = nullptr;
+    map_size = 0;
+    entries = nullptr;
+    count = 0;
+}
+
+int OpeningBook::lookup(const Position& pos) const noexcept
+{
+    if (!entries) {return -1;}
+    
+    int sym;
+    const Position key = pos.canonical(&sym);
+    
+    BookEntry probe {};
+    probe.player = key.player;
+    probe.opponent = key.opponent;
+    
+    const BookEntry* end = entries + count;
+    const BookEntry* it = std::lower_bound(entries, end, probe, entry_less);
+    if (it == end || it->player != key.player || it->opponent != key.opponent) {return -1;}
+    
+    // A damaged file must not make the computer play an illegal move
+    if (it->move >= NUM_SQUARES) {return -1;}
+    const int sq = untransform_square(it->move, sym);
+    return pos.is_legal(sq) ? sq : -1;
+}
+
+bool OpeningBook::write(const std::string& path, std::vector<BookEntry> entries)
+{
+    std::sort(entries.begin(), entries.end(), entry_less);
+    
+    BookHeader header;
+    std::memcpy(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    header.version = BOOK_VERSION;
+    header.count = entries.size();
+    
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {return false;}
+    
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+    if (ok && !entries.empty()) {
+        ok = std::fwrite(entries.data(), sizeof(BookEntry), entries.size(), f) == entries.size();
+    }
+    return std::fclose(f) == 0 && ok;
+}
+
+} // namespace reversi
@@ -0,0 +1,59 @@
+#ifndef REVERSI_OPENING_BOOK_HEADER
+#define REVERSI_OPENING_BOOK_HEADER
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Position.h"
+
+namespace reversi {
+
+/* One book position. Positions are stored in canonical form (see
+ * Position::canonical()) and the move in the same orientation */
+struct BookEntry {
+    std::uint64_t player;
+    std::uint64_t opponent;
+    std::uint32_t games;    // games of the records that played the move here
+    std::int16_t score;     // their mean final disc difference for the side to move
+    std::uint8_t move;
+    std::uint8_t reserved;
+};
+
+static_assert(sizeof(BookEntry) == 24, "BookEntry is written to disk as is");
+
+/* Opening book file: a 16 byte header followed by the entries sorted by
+ * position, little endian. The file is mapped read only, so opening it 
+ * costs nothing and processes using the same book share its pages */
+class OpeningBook {
+public:
+    OpeningBook() = default;
+    ~OpeningBook() {close();}
+    
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+    
+    // Returns false if the file can't be mapped or isn't a book
+    bool open(const std::string& path);
+    void close() noexcept;
+    
+    bool is_open() const noexcept {return entries != nullptr;}
+    std::size_t size() const noexcept {return count;}
+    
+    // Book move for pos, in any orientation, or -1 if pos is not in the book
+    int lookup(const Position& pos) const noexcept;
+    
+    // Sorts entries and writes them as a book file. Returns false on I/O errors
+    static bool write(const std::string& path, std::vector<BookEntry> entries);
+    
+private:
+    void* map = nullptr;
+    std::size_t map_size = 0;
+    const BookEntry* entries = nullptr;
+    std::size_t count = 0;
+};
+
+} // namespace reversi
+
+#endif // REVERSI_OPENING_BOOK_HEADER
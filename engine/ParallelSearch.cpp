@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MoveList.h"
+#include "ParallelSearch.h"
+
+namespace reversi {
+
+SearchResult ParallelSearch::run(const Position& pos, const SearchLimits& limits)
+{
+    // The endgame solver runs on a single thread
+    if (threads == 1 || mode == ParallelMode::none || pos.num_empties() <= limits.endgame_empties) {
+        Search search(tt);
+        return search.run(pos, limits);
+    }
+    
+    if (mode == ParallelMode::root) {return run_root(pos, limits);}
+    else {return run_lazy_smp(pos, limits);}
+}
+
+SearchResult ParallelSearch::run_lazy_smp(const Position& pos, const SearchLimits& limits)
+{
+    // Helpers have no limits of their own, they stop when the main thread is done
+    std::atomic<bool> done {false};
+    SearchLimits helper_limits;
+    helper_limits.stop = &done;
+    helper_limits.patterns = limits.patterns;
+    helper_limits.probcut = limits.probcut;
+    helper_limits.progress = limits.progress;
+    
+    std::vector<std::unique_ptr<Search>> helpers;
+    std::vector<std::thread> workers;
+    std::vector<SearchResult> helper_results (threads - 1);
+    
+    for (int i=1; i<threads; ++i) {
+        helpers.emplace_back(new Search(tt));
+        helpers.back()->set_thread_id(i);
+        
+        Search* helper = helpers.back().get();
+        SearchResult* result = &helper_results[i-1];
+        workers.emplace_back([helper, result, &pos, &helper_limits]() {
+            *result = helper->run(pos, helper_limits);
+        });
+    }
+    
+    Search main_search(tt);
+    SearchResult res = main_search.run(pos, limits);
+    
+    done = true;
+    for (auto& w: workers) {w.join();}
+    
+    for (const auto& r: helper_results) {
+        res.nodes += r.nodes;
+        res.evals += r.evals;
+    }
+    return res;
+}
+
+SearchResult ParallelSearch::run_root(const Position& pos, const SearchLimits& limits)
+{
+    const Search::Clock::time_point start = Search::Clock::now();
+    
+    SearchResult res;
+    if (!pos.has_moves()) {return res;}
+    
+    std::vector<std::unique_ptr<Search>> searches;
+    for (int i=0; i<threads; ++i) {
+        searches.emplace_back(new Search(tt));
+        searches.back()->begin(limits, start);
+    }
+    
+    if (tt) {tt->new_search();}
+    
+    const int max_depth = std::min(limits.depth, MAX_DEPTH);
+    
+    for (int depth = 1; depth <= max_depth; ++depth) {
+        for (auto& s: searches) {s->begin_iteration(depth, res.pv);}
+        
+        // Root moves in raster order, the previous best first
+        MoveList moves (pos.moves());
+        moves.move_to_front(res.move);
+        
+        // The first move is searched alone with a full window to get a bound
+        Search& main_search = *searches[0];
+        int best_score = main_search.search_move(pos, moves[0], depth, -SCORE_INF, SCORE_INF);
+        if (main_search.stopped()) {break;}
+        
+        int best_move = moves[0];
+        std::vector<int> best_line = main_search.line();
+        
+        std::mutex best_mutex;
+        std::atomic<int> alpha {best_score};
+        std::atomic<int> next {1};
+        
+        auto work = [&](Search& s) {
+            for (int i = next++; i < moves.size(); i = next++) {
+                const int a = alpha.load();
+                int score = s.search_move(pos, moves[i], depth, a, a + 1);
+                
+                if (score > a && !s.stopped()) {
+                    score = s.search_move(pos, moves[i], depth, a, SCORE_INF);
+                }
+                if (s.stopped()) {return;}
+                
+                std::lock_guard<std::mutex> lock (best_mutex);
+                if (score > best_score) {
+                    best_score = score;
+                    best_move = moves[i];
+                    best_line = s.line();
+                    alpha = score;
+                }
+            }
+        };
+        
+        std::vector<std::thread> workers;
+        for (int i=1; i<threads; ++i) {
+            workers.emplace_back(work, std::ref(*searches[i]));
+        }
+        work(main_search);
+        for (auto& w: workers) {w.join();}
+        
+        // An iteration counts only if every thread finished its share
+        const bool stopped = std::any_of(searches.begin(), searches.end(), 
+                                         [](const std::unique_ptr<Search>& s) {return s->stopped();});
+        if (stopped) {break;}
+        
+        res.move = best_move;
+        res.score = best_score;
+        res.depth = depth;
+        res.pv = best_line;
+        
+        if (limits.progress) {limits.progress->set_iteration(depth, best_score, best_line.data(), best_line.size());}
+        
+        if (depth >= pos.num_empties()) {break;}
+        
+        if (limits.time_ms > 0) {
+            const auto elapsed = Search::Clock::now() - start;
+            if (elapsed * 2 > std::chrono::milliseconds(limits.time_ms)) {break;}
+        }
+    }
+    
+    for (auto& s: searches) {
+        s->finish();
+        res.nodes += s->node_count();
+        res.evals += s->eval_count();
+        res.cutoffs += s->cutoff_stats();
+    }
+    res.time_ms = std::chrono::duration<double, std::milli>(Search::Clock::now() - start).count();
+    return res;
+}
+
+} // namespace reversi
@@ -0,0 +1,39 @@
+#ifndef REVERSI_PARALLEL_SEARCH_HEADER
+#define REVERSI_PARALLEL_SEARCH_HEADER
+
+#include "Search.h"
+
+namespace reversi {
+
+enum class ParallelMode {
+    none=0,    // a single thread
+    root,      // root moves split between threads, one iteration at a time
+    lazy_smp   // every thread searches the whole tree, sharing the table
+};
+
+/* Runs a search on several threads sharing one transposition table.
+ * In root mode the first root move of each iteration is searched alone
+ * to get a bound, then the threads take the remaining moves one by one
+ * and search them with a null window around the best score so far.
+ * In lazy SMP mode helper threads search the same root independently 
+ * and only help through the entries they leave in the table; the main
+ * thread's result is returned. Node and evaluation counts include
+ * all threads */
+class ParallelSearch {
+    TranspositionTable* tt;
+    int threads;
+    ParallelMode mode;
+    
+    SearchResult run_root(const Position& pos, const SearchLimits& limits);
+    SearchResult run_lazy_smp(const Position& pos, const SearchLimits& limits);
+    
+public:
+    ParallelSearch(TranspositionTable* table, const int num_threads, const ParallelMode m) noexcept
+        : tt{table}, threads{num_threads < 1 ? 1 : num_threads}, mode{m} {}
+    
+    SearchResult run(const Position& pos, const SearchLimits& limits);
+};
+
+} // namespace reversi
+
+#endif // REVERSI_PARALLEL_SEARCH_HEADER
@@ -0,0 +1,319 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define REVERSI_X86 1
+#endif
+
+#include "Patterns.h"
+#include "Evaluation.h"
+
+namespace reversi {
+
+namespace {
+
+constexpr Bitboard row_mask(const int row) noexcept {return Bitboard{0xFF} << (8 * row);}
+
+constexpr Bitboard diagonal(const int offset) noexcept
+{
+    // Cells (r, r + offset)
+    Bitboard b = 0;
+    for (int r=0; r + offset < BOARD_SIZE; ++r) {b |= bit(square(r, r + offset));}
+    return b;
+}
+
+// Base instance of each pattern, in the top left corner or along the top edge
+const Bitboard PATTERN_MASKS[] = {
+    row_mask(0) | bit(square(1, 1)) | bit(square(1, 6)),          // edge + 2X
+    0x070707ULL,                                                  // corner 3x3
+    0x1F1FULL,                                                    // corner 2x5
+    row_mask(1),                                                  // 2nd line
+    row_mask(2),                                                  // 3rd line
+    row_mask(3),                                                  // 4th line
+    diagonal(0),                                                  // diagonals of 8 to 4
+    diagonal(1),
+    diagonal(2),
+    diagonal(3),
+    diagonal(4)
+};
+
+constexpr int NUM_PATTERNS = sizeof(PATTERN_MASKS) / sizeof(PATTERN_MASKS[0]);
+
+// Groups of 8 features gathered at once
+constexpr int NUM_LANES = (NUM_FEATURES + 7) / 8 * 8;
+
+// Where each feature is and which table it uses
+struct FeatureTable {
+    Bitboard mask[NUM_FEATURES];       // cells of the instance on the board
+    int pattern[NUM_FEATURES];
+    int ternary[NUM_FEATURES];         // start of its base 3 table in digits[]
+    std::int32_t offset[NUM_PATTERNS]; // of the pattern's weights in a phase table
+    int size;                          // entries of a phase table, padding included
+    int zero;                          // entry left at 0 for unused lanes
+    int coverage[NUM_SQUARES];         // features covering each cell
+    
+    // Features covering each cell and the power of 3 of its digit there
+    int cell_feature[NUM_SQUARES][8];
+    int cell_power[NUM_SQUARES][8];
+    
+    /* For each instance, the cells taken by one side (extracted in board
+     * order) as a base 3 number of 0 and 1 digits in the order of the 
+     * cells of the base instance */
+    std::vector<std::uint16_t> digits;
+};
+
+int pow3(const int n) noexcept
+{
+    int res = 1;
+    for (int i=0; i<n; ++i) {res *= 3;}
+    return res;
+}
+
+FeatureTable make_feature_table()
+{
+    FeatureTable t {};
+    int n = 0, offset = 0;
+    
+    for (int p=0; p<NUM_PATTERNS; ++p) {
+        const Bitboard base = PATTERN_MASKS[p];
+        const int cells = popcount(base);
+        t.offset[p] = offset;
+        offset += pow3(cells);
+        
+        // One instance per distinct image of the base instance
+        for (int s=0; s<NUM_SYMMETRIES; ++s) {
+            const Bitboard image = transform(base, s);
+            bool found = false;
+            for (int i=0; i<n; ++i) {found = found || t.mask[i] == image;}
+            if (found) {continue;}
+            
+            t.mask[n] = image;
+            t.pattern[n] = p;
+            t.ternary[n] = static_cast<int>(t.digits.size());
+            
+            // Digit of the j-th cell of the image, in board order
+            int power[10];
+            int j = 0;
+            for (Bitboard m = image; m; m &= m - 1, ++j) {
+                const Bitboard cell = untransform(m & (~m + 1), s);
+                power[j] = pow3(popcount(base & (cell - 1)));
+                
+                const int sq = first_square(m);
+                t.cell_feature[sq][t.coverage[sq]] = n;
+                t.cell_power[sq][t.coverage[sq]] = power[j];
+                ++t.coverage[sq];
+            }
+            
+            for (int b=0; b<(1 << cells); ++b) {
+                int v = 0;
+                for (int k=0; k<cells; ++k) {
+                    if (b & (1 << k)) {v += power[k];}
+                }
+                t.digits.push_back(static_cast<std::uint16_t>(v));
+            }
+            
+            ++n;
+        }
+    }
+    
+    t.zero = offset;
+    t.size = offset + 2; // a 32 bit gather of the last entry reads one more
+    return t;
+}
+
+const FeatureTable FEATURES = make_feature_table();
+
+// Without pext, each disc adds its digit to the features covering its cell
+void features_portable(const Position& pos, std::int32_t* offsets) noexcept
+{
+    for (int f=0; f<NUM_FEATURES; ++f) {offsets[f] = FEATURES.offset[FEATURES.pattern[f]];}
+    
+    for (Bitboard b = pos.player; b; b &= b - 1) {
+        const int sq = first_square(b);
+        for (int i=0; i<FEATURES.coverage[sq]; ++i) {
+            offsets[FEATURES.cell_feature[sq][i]] += FEATURES.cell_power[sq][i];
+        }
+    }
+    for (Bitboard b = pos.opponent; b; b &= b - 1) {
+        const int sq = first_square(b);
+        for (int i=0; i<FEATURES.coverage[sq]; ++i) {
+            offsets[FEATURES.cell_feature[sq][i]] += 2 * FEATURES.cell_power[sq][i];
+        }
+    }
+}
+
+#ifdef REVERSI_X86
+__attribute__((target("bmi2")))
+void features_bmi2(const Position& pos, std::int32_t* offsets) noexcept
+{
+    const std::uint16_t* digits = FEATURES.digits.data();
+    
+    for (int f=0; f<NUM_FEATURES; ++f) {
+        const Bitboard mask = FEATURES.mask[f];
+        const std::uint16_t* d = digits + FEATURES.ternary[f];
+        offsets[f] = FEATURES.offset[FEATURES.pattern[f]] + d[_pext_u64(pos.player, mask)]
+                                                      + 2 * d[_pext_u64(pos.opponent, mask)];
+    }
+}
+
+__attribute__((target("avx2,bmi2")))
+int sum_avx2(const std::int16_t* table, const std::int32_t* offsets) noexcept
+{
+    __m256i sum = _mm256_setzero_si256();
+    
+    for (int f=0; f<NUM_LANES; f+=8) {
+        const __m256i idx = _mm256_load_si256(reinterpret_cast<const __m256i*>(offsets + f));
+        
+        // 32 bits at each 16 bit weight, of which the low half is the weight
+        __m256i w = _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), idx, 2);
+        w = _mm256_srai_epi32(_mm256_slli_epi32(w, 16), 16);
+        sum = _mm256_add_epi32(sum, w);
+    }
+    
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+#endif
+
+struct WeightHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t phases;
+    std::uint32_t size;
+};
+
+static_assert(sizeof(WeightHeader) == 16, "WeightHeader is written to disk as is");
+
+const char WEIGHT_MAGIC[4] = {'R', 'V', 'P', 'W'};
+const std::uint32_t WEIGHT_VERSION = 1;
+
+// No position is worth more than all the discs
+inline int clamp(const int score) noexcept
+{
+    const int bound = NUM_SQUARES * PATTERN_SCALE;
+    return score > bound ? bound : score < -bound ? -bound : score;
+}
+
+} // namespace
+
+PatternEvaluator::PatternEvaluator() 
+    : weights(static_cast<std::size_t>(NUM_PHASES) * FEATURES.size, 0)
+{
+#ifdef REVERSI_X86
+    avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2");
+#endif
+    
+    // Square values shared between the features covering each cell
+    const int scale = PATTERN_SCALE / 8;
+    
+    for (int p=0; p<NUM_PATTERNS; ++p) {
+        const Bitboard mask = PATTERN_MASKS[p];
+        const int cells = popcount(mask);
+        
+        for (int idx=0; idx<pow3(cells); ++idx) {
+            double value = 0;
+            int rest = idx, j = 0;
+            
+            for (Bitboard m = mask; m; m &= m - 1, ++j, rest /= 3) {
+                const int sq = first_square(m);
+                const int digit = rest % 3;
+                const double v = static_cast<double>(SQUARE_VALUES[sq]) / FEATURES.coverage[sq];
+                if (digit == 1) {value += v;}
+                else if (digit == 2) {value -= v;}
+            }
+            
+            const auto w = static_cast<std::int16_t>(std::lround(scale * value));
+            for (int ph=0; ph<NUM_PHASES; ++ph) {table(ph)[FEATURES.offset[p] + idx] = w;}
+        }
+    }
+}
+
+int PatternEvaluator::phase(const Position& pos) noexcept
+{
+    const int ph = (NUM_SQUARES - 4 - pos.num_empties()) / 4;
+    return ph < NUM_PHASES ? ph : NUM_PHASES - 1;
+}
+
+int PatternEvaluator::table_size() noexcept
+{
+    return FEATURES.size;
+}
+
+void PatternEvaluator::features(const Position& pos, std::int32_t* offsets) noexcept
+{
+#ifdef REVERSI_X86
+    static const bool bmi2 = __builtin_cpu_supports("bmi2");
+    if (bmi2) {
+        features_bmi2(pos, offsets);
+        return;
+    }
+#endif
+    features_portable(pos, offsets);
+}
+
+int PatternEvaluator::evaluate(const Position& pos) const noexcept
+{
+    const std::int16_t* t = table(phase(pos));
+    
+    alignas(32) std::int32_t offsets[NUM_LANES];
+    
+#ifdef REVERSI_X86
+    if (avx2) {
+        features_bmi2(pos, offsets);
+        for (int f=NUM_FEATURES; f<NUM_LANES; ++f) {offsets[f] = FEATURES.zero;}
+        return clamp(sum_avx2(t, offsets));
+    }
+#endif
+    
+    features_portable(pos, offsets);
+    int sum = 0;
+    for (int f=0; f<NUM_FEATURES; ++f) {sum += t[offsets[f]];}
+    return clamp(sum);
+}
+
+bool PatternEvaluator::load(const std::string& path)
+{
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {return false;}
+    
+    WeightHeader header;
+    std::vector<std::int16_t> w(weights.size());
+    
+    bool ok = std::fread(&header, sizeof(header), 1, f) == 1
+           && std::memcmp(header.magic, WEIGHT_MAGIC, sizeof(WEIGHT_MAGIC)) == 0
+           && header.version == WEIGHT_VERSION
+           && header.phases == NUM_PHASES
+           && header.size == static_cast<std::uint32_t>(FEATURES.size)
+           && std::fread(w.data(), sizeof(std::int16_t), w.size(), f) == w.size();
+    std::fclose(f);
+    
+    if (!ok) {return false;}
+    
+    // Unused lanes must add nothing
+    for (int ph=0; ph<NUM_PHASES; ++ph) {w[ph * FEATURES.size + FEATURES.zero] = 0;}
+    weights.swap(w);
+    return true;
+}
+
+bool PatternEvaluator::save(const std::string& path) const
+{
+    WeightHeader header;
+    std::memcpy(header.magic, WEIGHT_MAGIC, sizeof(WEIGHT_MAGIC));
+    header.version = WEIGHT_VERSION;
+    header.phases = NUM_PHASES;
+    header.size = static_cast<std::uint32_t>(FEATURES.size);
+    
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {return false;}
+    
+    const bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1
+                 && std::fwrite(weights.data(), sizeof(std::int16_t), weights.size(), f) == weights.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+} // namespace reversi
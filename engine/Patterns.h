@@ -0,0 +1,65 @@
+#ifndef REVERSI_PATTERNS_HEADER
+#define REVERSI_PATTERNS_HEADER
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Position.h"
+
+namespace reversi {
+
+// Pattern scores are in 1/PATTERN_SCALE of a disc
+constexpr int PATTERN_SCALE = 128;
+
+// Tables for each stage of the game, 4 plies apart
+constexpr int NUM_PHASES = 15;
+
+// Pattern instances on the board (all symmetries of the 11 patterns below)
+constexpr int NUM_FEATURES = 46;
+
+/* Evaluation by patterns: the contents of each instance of a pattern
+ * (edge with both X squares, 3x3 and 2x5 corners, the 2nd to 4th lines,
+ * the diagonals of 4 to 8 cells) index a table of weights, one table per
+ * pattern and phase of the game shared by its symmetric instances. The 
+ * score is the sum of the weights. The cells of each instance are 
+ * extracted with pext and read as a number in base 3 (empty 0, side to 
+ * move 1, opponent 2) in the cell order of the base instance; without 
+ * BMI2 each disc adds its digit to the instances covering it. On CPUs 
+ * with AVX2 the weights are fetched 8 at a time with gathers.
+ * Until trained weights are loaded the tables hold the square table of
+ * the heuristic evaluation, spread over the patterns covering each cell.
+ * tools/train fits the weights to the results of recorded games */
+class PatternEvaluator {
+public:
+    PatternEvaluator();
+    
+    // Score for the side to move, in 1/PATTERN_SCALE discs (at most 64 discs)
+    int evaluate(const Position& pos) const noexcept;
+    
+    static int phase(const Position& pos) noexcept;
+    
+    // Offsets into the table of a phase of each feature of pos, used by evaluate()
+    static void features(const Position& pos, std::int32_t* offsets) noexcept;
+    
+    // Entries in the table of one phase, padding included
+    static int table_size() noexcept;
+    
+    std::int16_t* table(const int ph) noexcept {return &weights[ph * table_size()];}
+    const std::int16_t* table(const int ph) const noexcept {return &weights[ph * table_size()];}
+    
+    bool uses_avx2() const noexcept {return avx2;}
+    
+    /* Weight file written by tools/train. Returns false, leaving the
+     * weights as they were, if it can't be read or has other tables */
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    
+private:
+    std::vector<std::int16_t> weights;
+    bool avx2 = false;
+};
+
+} // namespace reversi
+
+#endif // REVERSI_PATTERNS_HEADER
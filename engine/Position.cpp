@@ -0,0 +1,199 @@
+#include <array>
+
+#include "Position.h"
+
+namespace reversi {
+
+namespace {
+
+// Every column but the outer ones. Masking opponent discs with it keeps
+// horizontal and diagonal shifts from wrapping around to the next row
+const Bitboard INNER_COLS = 0x7E7E7E7E7E7E7E7EULL;
+const Bitboard NOT_A_FILE = 0xFEFEFEFEFEFEFEFEULL;
+const Bitboard NOT_H_FILE = 0x7F7F7F7F7F7F7F7FULL;
+
+// Positive S shifts towards higher squares (east/south), negative S towards lower ones
+template<int S>
+inline Bitboard shift(const Bitboard b) noexcept
+{
+    return S > 0 ? b << (S > 0 ? S : 0) : b >> (S > 0 ? 0 : -S);
+}
+
+template<int S>
+inline Bitboard moves_towards(const Bitboard player, 
+                              const Bitboard mask, 
+                              const Bitboard empty) noexcept
+{
+    // A run of opponent discs is at most 6 cells long
+    Bitboard x = shift<S>(player) & mask;
+    x |= shift<S>(x) & mask;
+    x |= shift<S>(x) & mask;
+    x |= shift<S>(x) & mask;
+    x |= shift<S>(x) & mask;
+    x |= shift<S>(x) & mask;
+    return shift<S>(x) & empty;
+}
+
+template<int S>
+inline Bitboard flips_towards(const Bitboard player, 
+                              const Bitboard mask, 
+                              const Bitboard origin) noexcept
+{
+    Bitboard flipped = 0;
+    Bitboard x = shift<S>(origin);
+    
+    while (x & mask) {
+        flipped |= x;
+        x = shift<S>(x);
+    }
+    
+    // The run must be closed by one of our discs
+    return (x & player) ? flipped : 0;
+}
+
+/* Zobrist keys, one per (side, row, contents of the row) instead of
+ * one per (side, cell): xoring 16 of them hashes a position without
+ * walking its discs one by one */
+using ZobristTable = std::array<std::array<std::array<std::uint64_t, 256>, 8>, 2>;
+
+ZobristTable make_zobrist_table() noexcept
+{
+    ZobristTable table;
+    std::uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    
+    for (auto& side: table) {
+        for (auto& row: side) {
+            for (auto& key: row) {
+                // splitmix64, so the keys are the same in every run
+                std::uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                key = z ^ (z >> 31);
+            }
+        }
+    }
+    return table;
+}
+
+const ZobristTable ZOBRIST = make_zobrist_table();
+
+inline Bitboard flip_rows(const Bitboard b) noexcept {return __builtin_bswap64(b);}
+
+inline Bitboard mirror_cols(Bitboard b) noexcept
+{
+    b = ((b >> 1) & 0x5555555555555555ULL) | ((b & 0x5555555555555555ULL) << 1);
+    b = ((b >> 2) & 0x3333333333333333ULL) | ((b & 0x3333333333333333ULL) << 2);
+    return ((b >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((b & 0x0F0F0F0F0F0F0F0FULL) << 4);
+}
+
+// Swaps rows and columns, (row, col) goes to (col, row)
+inline Bitboard transpose(Bitboard b) noexcept
+{
+    Bitboard t = 0x0F0F0F0F00000000ULL & (b ^ (b << 28));
+    b ^= t ^ (t >> 28);
+    t = 0x3333000033330000ULL & (b ^ (b << 14));
+    b ^= t ^ (t >> 14);
+    t = 0x5500550055005500ULL & (b ^ (b << 7));
+    return b ^ t ^ (t >> 7);
+}
+
+} // namespace
+
+Bitboard get_moves(const Bitboard player, const Bitboard opponent) noexcept
+{
+    const Bitboard empty = ~(player | opponent);
+    const Bitboard inner = opponent & INNER_COLS;
+    
+    return moves_towards<1>(player, inner, empty)    |
+           moves_towards<-1>(player, inner, empty)   |
+           moves_towards<8>(player, opponent, empty) |
+           moves_towards<-8>(player, opponent, empty)|
+           moves_towards<7>(player, inner, empty)    |
+           moves_towards<-7>(player, inner, empty)   |
+           moves_towards<9>(player, inner, empty)    |
+           moves_towards<-9>(player, inner, empty);
+}
+
+Bitboard get_flips(const Bitboard player, const Bitboard opponent, const int sq) noexcept
+{
+    const Bitboard origin = bit(sq);
+    const Bitboard inner = opponent & INNER_COLS;
+    
+    return flips_towards<1>(player, inner, origin)    |
+           flips_towards<-1>(player, inner, origin)   |
+           flips_towards<8>(player, opponent, origin) |
+           flips_towards<-8>(player, opponent, origin)|
+           flips_towards<7>(player, inner, origin)    |
+           flips_towards<-7>(player, inner, origin)   |
+           flips_towards<9>(player, inner, origin)    |
+           flips_towards<-9>(player, inner, origin);
+}
+
+Bitboard transform(Bitboard b, const int sym) noexcept
+{
+    if (sym & 1) {b = flip_rows(b);}
+    if (sym & 2) {b = mirror_cols(b);}
+    if (sym & 4) {b = transpose(b);}
+    return b;
+}
+
+Bitboard untransform(Bitboard b, const int sym) noexcept
+{
+    if (sym & 4) {b = transpose(b);}
+    if (sym & 2) {b = mirror_cols(b);}
+    if (sym & 1) {b = flip_rows(b);}
+    return b;
+}
+
+Bitboard get_neighbours(const Bitboard b) noexcept
+{
+    const Bitboard east = (b << 1) & NOT_A_FILE;
+    const Bitboard west = (b >> 1) & NOT_H_FILE;
+    const Bitboard row = b | east | west;
+    
+    return east | west | (row << 8) | (row >> 8);
+}
+
+Position Position::initial() noexcept
+{
+    // Black on (3,4) and (4,3), White on (3,3) and (4,4)
+    return Position{bit(square(3, 4)) | bit(square(4, 3)),
+                    bit(square(3, 3)) | bit(square(4, 4))};
+}
+
+Position Position::play(const int sq) const noexcept
+{
+    const Bitboard flipped = get_flips(player, opponent, sq);
+    
+    return Position{opponent ^ flipped, player ^ flipped ^ bit(sq)};
+}
+
+Position Position::canonical(int* sym) const noexcept
+{
+    Position best = *this;
+    int best_sym = 0;
+    
+    for (int s=1; s<NUM_SYMMETRIES; ++s) {
+        const Position image = transform(s);
+        if (image < best) {
+            best = image;
+            best_sym = s;
+        }
+    }
+    
+    if (sym) {*sym = best_sym;}
+    return best;
+}
+
+std::uint64_t Position::hash() const noexcept
+{
+    std::uint64_t key = 0;
+    
+    for (int i=0; i<BOARD_SIZE; ++i) {
+        key ^= ZOBRIST[0][i][(player >> (8 * i)) & 0xFF];
+        key ^= ZOBRIST[1][i][(opponent >> (8 * i)) & 0xFF];
+    }
+    return key;
+}
+
+} // namespace reversi
@@ -0,0 +1,104 @@
+#ifndef REVERSI_POSITION_HEADER
+#define REVERSI_POSITION_HEADER
+
+#include <cstdint>
+
+namespace reversi {
+
+/* One bit per cell: bit (row * 8 + col) is set when the cell is taken,
+ * so bit 0 is the top-left cell and bit 63 the bottom-right one */
+using Bitboard = std::uint64_t;
+
+constexpr int BOARD_SIZE = 8;
+constexpr int NUM_SQUARES = 64;
+
+constexpr int square(const int row, const int col) noexcept
+{
+    return row * BOARD_SIZE + col;
+}
+
+constexpr int row_of(const int sq) noexcept {return sq >> 3;}
+constexpr int col_of(const int sq) noexcept {return sq & 7;}
+constexpr Bitboard bit(const int sq) noexcept {return Bitboard{1} << sq;}
+
+inline int popcount(const Bitboard b) noexcept {return __builtin_popcountll(b);}
+
+// Index of the lowest set bit. b must not be empty
+inline int first_square(const Bitboard b) noexcept {return __builtin_ctzll(b);}
+
+// Squares where player can move, i.e. that outflank at least one opponent disc
+Bitboard get_moves(const Bitboard player, const Bitboard opponent) noexcept;
+
+// Opponent discs flipped when player moves on sq (empty if the move is illegal)
+Bitboard get_flips(const Bitboard player, const Bitboard opponent, const int sq) noexcept;
+
+// Cells adjacent (in any of the 8 directions) to some cell of b
+Bitboard get_neighbours(const Bitboard b) noexcept;
+
+/* The 8 symmetries of the board. In a symmetry number, bit 0 turns the 
+ * rows upside down, bit 1 mirrors the columns and bit 2 transposes, 
+ * applied in that order. untransform() undoes transform() */
+constexpr int NUM_SYMMETRIES = 8;
+
+Bitboard transform(const Bitboard b, const int sym) noexcept;
+Bitboard untransform(const Bitboard b, const int sym) noexcept;
+
+inline int transform_square(const int sq, const int sym) noexcept
+{
+    return first_square(transform(bit(sq), sym));
+}
+
+inline int untransform_square(const int sq, const int sym) noexcept
+{
+    return first_square(untransform(bit(sq), sym));
+}
+
+/* A position is always seen from the side to move: player holds its discs
+ * and opponent the discs of the other side. Colours are kept by the caller */
+struct Position {
+    Bitboard player = 0;
+    Bitboard opponent = 0;
+    
+    // Standard starting position with Black to move
+    static Position initial() noexcept;
+    
+    Bitboard moves() const noexcept {return get_moves(player, opponent);}
+    bool has_moves() const noexcept {return moves() != 0;}
+    bool is_legal(const int sq) const noexcept {return (moves() & bit(sq)) != 0;}
+    
+    Bitboard empties() const noexcept {return ~(player | opponent);}
+    int num_empties() const noexcept {return popcount(empties());}
+    
+    // Plays sq (which must be legal) and hands the turn to the other side
+    Position play(const int sq) const noexcept;
+    
+    Position pass() const noexcept {return Position{opponent, player};}
+    
+    // Zobrist key of the position
+    std::uint64_t hash() const noexcept;
+    
+    Position transform(const int sym) const noexcept
+    {
+        return Position{reversi::transform(player, sym), reversi::transform(opponent, sym)};
+    }
+    
+    /* The same position for all 8 symmetries: the image with the smallest 
+     * (player, opponent). If sym is given it gets the symmetry used */
+    Position canonical(int* sym = nullptr) const noexcept;
+};
+
+inline bool operator==(const Position& a, const Position& b) noexcept
+{
+    return a.player == b.player && a.opponent == b.opponent;
+}
+
+inline bool operator!=(const Position& a, const Position& b) noexcept {return !(a == b);}
+
+inline bool operator<(const Position& a, const Position& b) noexcept
+{
+    return a.player < b.player || (a.player == b.player && a.opponent < b.opponent);
+}
+
+} // namespace reversi
+
+#endif // REVERSI_POSITION_HEADER
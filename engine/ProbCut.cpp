@@ -0,0 +1,63 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "ProbCut.h"
+
+namespace reversi {
+
+bool ProbCut::add(const int depth, const Check& c) noexcept
+{
+    if (depth < 2 || depth > MAX_DEPTH || num_checks[depth] == MAX_PROBCUT_CHECKS) {return false;}
+    if (c.shallow < 1 || c.shallow >= depth || c.a <= 0 || c.sigma <= 0) {return false;}
+    
+    checks[depth][num_checks[depth]++] = c;
+    return true;
+}
+
+bool ProbCut::load(const std::string& path)
+{
+    std::ifstream in (path);
+    if (!in) {return false;}
+    
+    ProbCut p;
+    std::string line;
+    
+    while (std::getline(in, line)) {
+        std::istringstream fields (line);
+        std::string first;
+        if (!(fields >> first) || first[0] == '#') {continue;}
+        
+        if (first == "threshold") {
+            if (!(fields >> p.threshold) || p.threshold < 0) {return false;}
+            continue;
+        }
+        
+        int depth;
+        Check c;
+        std::istringstream depth_field (first);
+        if (!(depth_field >> depth) || !(fields >> c.shallow >> c.a >> c.b >> c.sigma)) {return false;}
+        if (!p.add(depth, c)) {return false;}
+    }
+    
+    *this = p;
+    return true;
+}
+
+bool ProbCut::save(const std::string& path) const
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {return false;}
+    
+    std::fprintf(f, "# Multi-ProbCut: depth shallow a b sigma, deep score = a * shallow score + b\n");
+    std::fprintf(f, "threshold %g\n", threshold);
+    for (int d=0; d<=MAX_DEPTH; ++d) {
+        for (int i=0; i<num_checks[d]; ++i) {
+            const Check& c = checks[d][i];
+            std::fprintf(f, "%d %d %.6f %.3f %.3f\n", d, c.shallow, c.a, c.b, c.sigma);
+        }
+    }
+    return std::fclose(f) == 0;
+}
+
+} // namespace reversi
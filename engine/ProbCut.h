@@ -0,0 +1,47 @@
+#ifndef REVERSI_PROBCUT_HEADER
+#define REVERSI_PROBCUT_HEADER
+
+#include <string>
+
+#include "Search.h"
+
+namespace reversi {
+
+// Shallow searches tried at most at each depth
+constexpr int MAX_PROBCUT_CHECKS = 2;
+
+/* Parameters of Multi-ProbCut. The scores of a search of some depth and
+ * of a shallower one of the same position are close to linearly related:
+ *     deep = a * shallow + b, give or take an error of deviation sigma
+ * so a null window search to the shallow depth can tell that the deep
+ * one would very likely fail high (a * shallow + b >= beta + t * sigma)
+ * or low (<= alpha - t * sigma), and the node is cut without searching
+ * it. t is the threshold, larger is safer and prunes less. Each depth
+ * has its own shallow depths and statistics, fitted by tools/probcut
+ * for one evaluation function: those of another would not hold */
+struct ProbCut {
+    struct Check {
+        int shallow = 0;
+        double a = 1;
+        double b = 0;
+        double sigma = 0;
+    };
+    
+    double threshold = 1.5;
+    Check checks[MAX_DEPTH + 1][MAX_PROBCUT_CHECKS];
+    int num_checks[MAX_DEPTH + 1] = {};
+    
+    // Returns false if depth already has all its checks or c can't be used at depth
+    bool add(const int depth, const Check& c) noexcept;
+    
+    /* Text file, one check per line as "depth shallow a b sigma", and a
+     * line "threshold t". Blank lines and lines starting with # are
+     * skipped. Returns false, leaving the parameters as they were, if
+     * the file can't be read or a line is wrong */
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+};
+
+} // namespace reversi
+
+#endif // REVERSI_PROBCUT_HEADER
@@ -0,0 +1,568 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Search.h"
+#include "Endgame.h"
+#include "ProbCut.h"
+
+namespace reversi {
+
+namespace {
+
+// Win, loss or draw for the side to move of a finished game
+inline int game_result(const Position& pos) noexcept
+{
+    const int pl_cnt = popcount(pos.player);
+    const int opp_cnt = popcount(pos.opponent);
+    
+    if (pl_cnt > opp_cnt) {return SCORE_WIN;}
+    if (pl_cnt < opp_cnt) {return -SCORE_WIN;}
+    return 0; // draw
+}
+
+/* Game over if the board is full or one side was wiped out. 
+ * Sets score to the result for the side to move */
+inline bool is_game_over(const Position& pos, int& score) noexcept
+{
+    if (pos.empties() == 0 || pos.player == 0 || pos.opponent == 0) {
+        score = game_result(pos);
+        return true;
+    }
+    return false;
+}
+
+// Scores of the moves tried before all others
+constexpr int ORDER_PREFERRED = 1 << 30;
+constexpr int ORDER_KILLER = 1 << 29;
+
+// Closer to the leaves counting the replies to each move costs more than it saves
+constexpr int MOBILITY_DEPTH = 3;
+
+// History scores are halved before reaching this, so one reply less outweighs any of them
+constexpr int HISTORY_MAX = 1 << 16;
+
+} // namespace
+
+void SearchProgress::reset()
+{
+    nodes = 0;
+    start = std::chrono::steady_clock::now();
+    
+    std::lock_guard<std::mutex> lock (mutex);
+    depth = 0;
+    score = 0;
+    pv_length = 0;
+}
+
+void SearchProgress::set_iteration(const int d, const int sc, const int* line, const int length) noexcept
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    depth = d;
+    score = sc;
+    pv_length = std::min(length, MAX_DEPTH + 1);
+    std::copy(line, line + pv_length, pv);
+}
+
+SearchProgress::Snapshot SearchProgress::snapshot() const
+{
+    Snapshot s;
+    s.nodes = nodes.load(std::memory_order_relaxed);
+    s.time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    std::lock_guard<std::mutex> lock (mutex);
+    s.depth = depth;
+    s.score = score;
+    s.pv.assign(pv, pv + pv_length);
+    return s;
+}
+
+CutoffStats& CutoffStats::operator+=(const CutoffStats& o) noexcept
+{
+    for (int i=0; i<=MAX_DEPTH; ++i) {
+        cutoffs[i] += o.cutoffs[i];
+        first_move[i] += o.first_move[i];
+    }
+    return *this;
+}
+
+SearchResult Search::run(const Position& pos, const int depth)
+{
+    SearchLimits limits;
+    limits.depth = depth;
+    return run(pos, limits);
+}
+
+SearchResult Search::run(const Position& pos, const SearchLimits& limits)
+{
+    const Clock::time_point start = Clock::now();
+    
+    SearchResult res;
+    
+    // The line is copied at each iteration, this is the only allocation of the search
+    res.pv.reserve(MAX_DEPTH);
+    
+    if (pos.num_empties() <= limits.endgame_empties && pos.has_moves()) {
+        EndgameSolver solver(tt, limits.stop, limits.progress);
+        res = solver.run(pos);
+        res.exact = !solver.stopped();
+        res.time_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        return res;
+    }
+    
+    begin(limits, start);
+    
+    if (tt && thread_id == 0) {tt->new_search();}
+    
+    const int max_depth = std::min(limits.depth, MAX_DEPTH);
+    
+    for (int depth = 1; depth <= max_depth; ++depth) {
+        SearchResult iteration;
+        
+        // Helpers go one ply deeper on every other iteration
+        const int d = thread_id > 0 ? std::min(max_depth, depth + (thread_id & 1)) : depth;
+        begin_iteration(d, res.pv);
+        
+        const bool completed = board.has_patterns() ? search_root<true>(pos, d, iteration)
+                                                    : search_root<false>(pos, d, iteration);
+        if (!completed || aborted) {break;}
+        
+        res.move = iteration.move;
+        res.score = iteration.score;
+        res.depth = d;
+        res.pv.assign(pv[0], pv[0] + pv_length[0]);
+        
+        if (progress && thread_id == 0) {progress->set_iteration(d, res.score, pv[0], pv_length[0]);}
+        
+        // Every line reaches the end of the game, deeper searches change nothing
+        if (depth >= pos.num_empties()) {break;}
+        
+        // The next iteration takes several times longer, don't start what can't finish
+        if (limits.time_ms > 0) {
+            const auto elapsed = Clock::now() - start;
+            if (elapsed * 2 > std::chrono::milliseconds(limits.time_ms)) {break;}
+        }
+    }
+    
+    finish();
+    
+    res.nodes = nodes;
+    res.evals = evals;
+    res.cutoffs = cutoffs;
+    res.time_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return res;
+}
+
+void Search::begin(const SearchLimits& limits, const Clock::time_point start) noexcept
+{
+    nodes = 0;
+    evals = 0;
+    published = 0;
+    tt_stats = TTStats{};
+    time_ms = limits.time_ms;
+    deadline = start + std::chrono::milliseconds(limits.time_ms);
+    stop = limits.stop;
+    aborted = false;
+    board.set_patterns(limits.patterns);
+    probcut = limits.probcut;
+    progress = limits.progress;
+    prev_pv_length = 0;
+    
+    for (auto& k: killers) {k[0] = k[1] = -1;}
+    std::fill(history, history + NUM_SQUARES, 0);
+    cutoffs = CutoffStats{};
+}
+
+void Search::begin_iteration(const int depth, const std::vector<int>& prev_line) noexcept
+{
+    // The first iteration always completes so there is a move to play
+    timed = time_ms > 0 && depth > 1;
+    
+    prev_pv_length = std::min<int>(prev_line.size(), MAX_DEPTH);
+    std::copy(prev_line.begin(), prev_line.begin() + prev_pv_length, prev_pv);
+}
+
+int Search::search_move(const Position& pos, 
+                        const int sq, 
+                        const int depth, 
+                        const int alpha, 
+                        const int beta)
+{
+    ++nodes;
+    follow_pv = prev_pv_length > 0 && prev_pv[0] == sq;
+    
+    board.reset(pos);
+    int score;
+    if (board.has_patterns()) {
+        board.make<true>(sq);
+        score = -pvs<true>(depth-1, 1, -beta, -alpha);
+        board.unmake<true>();
+    }
+    else {
+        board.make<false>(sq);
+        score = -pvs<false>(depth-1, 1, -beta, -alpha);
+        board.unmake<false>();
+    }
+    update_pv(0, sq);
+    follow_pv = false;
+    
+    return score;
+}
+
+void Search::finish() noexcept
+{
+    if (tt) {tt->record(tt_stats);}
+    publish_nodes();
+}
+
+/* One iteration. Returns false if it ran out of time, res is 
+ * only meaningful when it completed */
+template <bool Patterns>
+bool Search::search_root(const Position& pos, const int depth, SearchResult& res)
+{
+    ++nodes;
+    pv_length[0] = 0;
+    follow_pv = prev_pv_length > 0;
+    board.reset(pos);
+    
+    int alpha = -SCORE_INF;
+    
+    int hash_move = -1;
+    const std::uint64_t key = pos.hash();
+    TTEntry entry;
+    if (tt && tt->probe(key, entry)) {hash_move = entry.move;}
+    
+    const int preferred = prev_pv_length > 0 ? prev_pv[0] : hash_move;
+    
+    MoveList moves (pos.moves());
+    
+    // Helpers start the other root moves from a different square
+    const int rotation = (thread_id * 19) & 63;
+    if (rotation != 0) {
+        moves.move_to_front(preferred);
+        moves.rotate_from(rotation);
+    }
+    else {
+        order_moves(moves, pos, depth, 0, preferred);
+    }
+    
+    for (const int sq: moves) {
+        board.make<Patterns>(sq);
+        int score;
+        
+        if (res.move < 0) {
+            score = -pvs<Patterns>(depth-1, 1, -SCORE_INF, SCORE_INF);
+        }
+        else {
+            // Only a strictly better move replaces the first best one
+            score = -pvs<Patterns>(depth-1, 1, -alpha-1, -alpha);
+            if (score > alpha && !aborted) {
+                score = -pvs<Patterns>(depth-1, 1, -SCORE_INF, -alpha);
+            }
+        }
+        board.unmake<Patterns>();
+        follow_pv = false;
+        
+        if (aborted) {return false;}
+        
+        if (score > alpha) {
+            alpha = score;
+            res.move = sq;
+            res.score = score;
+            update_pv(0, sq);
+        }
+    }
+    
+    if (tt && res.move >= 0) {
+        ++tt_stats.stores;
+        if (tt->store(key, depth, res.score, Bound::exact, res.move)) {++tt_stats.replacements;}
+    }
+    
+    return true;
+}
+
+SearchResult Search::run_minimax(const Position& pos, const int depth)
+{
+    SearchResult res;
+    res.depth = depth;
+    nodes = 1;
+    evals = 0;
+    board.reset(pos);
+    
+    for (Bitboard moves = pos.moves(); moves; moves &= moves - 1) {
+        const int sq = first_square(moves);
+        board.make(sq);
+        const int score = board.has_patterns() ? -minimax<true>(depth-1) : -minimax<false>(depth-1);
+        board.unmake();
+        
+        if (score > res.score) {
+            res.move = sq;
+            res.score = score;
+        }
+    }
+    
+    res.nodes = nodes;
+    res.evals = evals;
+    return res;
+}
+
+inline bool Search::out_of_time() noexcept
+{
+    // Looking at the clock is slow, do it every few thousand nodes
+    if ((nodes & 4095) == 0) {
+        if (stop && stop->load(std::memory_order_relaxed)) {aborted = true;}
+        if (timed && Clock::now() >= deadline) {aborted = true;}
+        publish_nodes();
+    }
+    return aborted;
+}
+
+inline void Search::publish_nodes() noexcept
+{
+    if (progress) {
+        progress->add_nodes(nodes - published);
+        published = nodes;
+    }
+}
+
+inline void Search::update_pv(const int ply, const int move) noexcept
+{
+    pv[ply][0] = move;
+    std::copy(pv[ply+1], pv[ply+1] + pv_length[ply+1], pv[ply] + 1);
+    pv_length[ply] = pv_length[ply+1] + 1;
+}
+
+// Sorts moves, the likeliest to cause a cutoff first
+void Search::order_moves(MoveList& moves, 
+                         const Position& pos, 
+                         const int depth, 
+                         const int ply, 
+                         const int preferred) const noexcept
+{
+    for (int i=0; i<moves.size(); ++i) {
+        const int sq = moves[i];
+        int score;
+        
+        if (sq == preferred) {score = ORDER_PREFERRED;}
+        else if (sq == killers[ply][0]) {score = ORDER_KILLER + 1;}
+        else if (sq == killers[ply][1]) {score = ORDER_KILLER;}
+        else {
+            score = history[sq];
+            if (depth >= MOBILITY_DEPTH) {
+                score += (NUM_SQUARES - popcount(pos.play(sq).moves())) * HISTORY_MAX;
+            }
+        }
+        moves.set_score(i, score);
+    }
+    moves.sort();
+}
+
+// sq, the move at index in the ordered moves, caused a cutoff
+inline void Search::update_ordering(const int sq, const int depth, const int ply, const int index) noexcept
+{
+    ++cutoffs.cutoffs[ply];
+    if (index == 0) {++cutoffs.first_move[ply];}
+    
+    if (killers[ply][0] != sq) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = sq;
+    }
+    
+    history[sq] += depth * depth;
+    if (history[sq] >= HISTORY_MAX) {
+        for (auto& h: history) {h /= 2;}
+    }
+}
+
+/* Multi-ProbCut: the shallow searches of depth predict the deep one to
+ * fail high or low by more than the threshold allows. Sets score to the
+ * bound that failed. Searches the node shallower on the same board */
+template <bool Patterns>
+bool Search::probcut_cut(const int depth, const int ply, const int alpha, const int beta, int& score)
+{
+    if (depth > MAX_DEPTH) {return false;}
+    
+    for (int i=0; i<probcut->num_checks[depth]; ++i) {
+        const ProbCut::Check& c = probcut->checks[depth][i];
+        const double margin = probcut->threshold * c.sigma;
+        
+        // Shallow scores from which a * shallow + b clears the window by the margin
+        const double high = std::ceil((beta + margin - c.b) / c.a);
+        const double low = std::floor((alpha - margin - c.b) / c.a);
+        
+        if (high < SCORE_WIN) {
+            const int h = static_cast<int>(high);
+            if (pvs<Patterns>(c.shallow, ply, h - 1, h) >= h) {
+                score = beta;
+                return !aborted;
+            }
+        }
+        if (low > -SCORE_WIN) {
+            const int l = static_cast<int>(low);
+            if (pvs<Patterns>(c.shallow, ply, l, l + 1) <= l) {
+                score = alpha;
+                return !aborted;
+            }
+        }
+        if (aborted) {return false;}
+    }
+    return false;
+}
+
+/* Fail-soft negamax with null windows on the position of board. Scores
+ * are clamped to [-SCORE_WIN, SCORE_WIN] the same way minimax() does */
+template <bool Patterns>
+int Search::pvs(const int depth, const int ply, int alpha, const int beta)
+{
+    ++nodes;
+    pv_length[ply] = 0;
+    
+    // Once aborted the score is thrown away, just unwind
+    if (out_of_time()) {return 0;}
+    
+    // base cases
+    if (depth <= 0) {
+        ++evals;
+        return board.evaluate<Patterns>();
+    }
+    
+    const Position pos = board.position();
+    
+    int score;
+    if (is_game_over(pos, score)) {
+        return score;
+    }
+    
+    const Bitboard moves = pos.moves();
+    if (moves == 0) {
+        // Neither side can move: over at any depth, don't pass back and forth
+        if (!pos.pass().has_moves()) {return game_result(pos);}
+        
+        if (follow_pv && (ply >= prev_pv_length || prev_pv[ply] >= 0)) {follow_pv = false;}
+        
+        board.make_pass();
+        score = std::max(-SCORE_WIN, -pvs<Patterns>(depth-1, ply+1, -beta, -alpha));
+        board.unmake<Patterns>();
+        update_pv(ply, -1);
+        return score;
+    }
+    
+    const int alpha_orig = alpha;
+    const std::uint64_t key = pos.hash();
+    int hash_move = -1;
+    
+    TTEntry entry;
+    if (tt) {++tt_stats.probes;}
+    if (tt && tt->probe(key, entry)) {
+        ++tt_stats.hits;
+        hash_move = entry.move;
+        
+        if (entry.depth >= depth && !follow_pv) {
+            if (entry.bound == Bound::exact) {return entry.score;}
+            if (entry.bound == Bound::lower && entry.score >= beta) {return entry.score;}
+            if (entry.bound == Bound::upper && entry.score <= alpha) {return entry.score;}
+        }
+    }
+    
+    // Along the previous principal variation its move goes first, else the hash move
+    int preferred = hash_move;
+    if (follow_pv) {
+        if (ply < prev_pv_length && prev_pv[ply] >= 0 && (moves & bit(prev_pv[ply]))) {
+            preferred = prev_pv[ply];
+        }
+        else {
+            follow_pv = false;
+        }
+    }
+    
+    if (probcut && !follow_pv && beta - alpha == 1 && probcut_cut<Patterns>(depth, ply, alpha, beta, score)) {
+        return score;
+    }
+    
+    int best = -SCORE_WIN;
+    int best_move = -1;
+    bool first = true;
+    
+    MoveList list (moves);
+    order_moves(list, pos, depth, ply, preferred);
+    
+    for (int i=0; i<list.size(); ++i) {
+        const int sq = list[i];
+        board.make<Patterns>(sq);
+        
+        if (first) {
+            score = -pvs<Patterns>(depth-1, ply+1, -beta, -alpha);
+            first = false;
+            follow_pv = false;
+        }
+        else {
+            score = -pvs<Patterns>(depth-1, ply+1, -alpha-1, -alpha);
+            if (score > alpha && score < beta && !aborted) {
+                score = -pvs<Patterns>(depth-1, ply+1, -beta, -alpha);
+            }
+        }
+        board.unmake<Patterns>();
+        
+        if (aborted) {return 0;}
+        
+        if (score > best) {
+            best = score;
+            best_move = sq;
+            if (score > alpha) {
+                alpha = score;
+                update_pv(ply, sq);
+                if (alpha >= beta) { // cutoff
+                    update_ordering(sq, depth, ply, i);
+                    break;
+                }
+            }
+        }
+    }
+    
+    if (tt) {
+        const Bound bound = best <= alpha_orig ? Bound::upper
+                          : best >= beta ? Bound::lower 
+                          : Bound::exact;
+        ++tt_stats.stores;
+        if (tt->store(key, depth, best, bound, best_move)) {++tt_stats.replacements;}
+    }
+    
+    return best;
+}
+
+template <bool Patterns>
+int Search::minimax(const int depth)
+{
+    ++nodes;
+    
+    if (depth <= 0) {
+        ++evals;
+        return board.evaluate<Patterns>();
+    }
+    
+    const Position pos = board.position();
+    
+    int score;
+    if (is_game_over(pos, score)) {
+        return score;
+    }
+    
+    const Bitboard moves = pos.moves();
+    if (moves == 0) {
+        if (!pos.pass().has_moves()) {return game_result(pos);}
+        
+        board.make_pass();
+        const int score = std::max(-SCORE_WIN, -minimax<Patterns>(depth-1));
+        board.unmake<Patterns>();
+        return score;
+    }
+    
+    int best = -SCORE_WIN;
+    for (Bitboard mv = moves; mv; mv &= mv - 1) {
+        board.make<Patterns>(first_square(mv));
+        best = std::max(best, -minimax<Patterns>(depth-1));
+        board.unmake<Patterns>();
+    }
+    return best;
+}
+
+} // namespace reversi
@@ -0,0 +1,204 @@
+#ifndef REVERSI_SEARCH_HEADER
+#define REVERSI_SEARCH_HEADER
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "Board.h"
+#include "MoveList.h"
+#include "Position.h"
+#include "TranspositionTable.h"
+
+namespace reversi {
+
+struct ProbCut;
+class SearchProgress;
+
+// Score of a finished game, as seen by the side to move
+constexpr int SCORE_WIN = 100000;
+
+// Bound above any score, heuristic ones included
+constexpr int SCORE_INF = 1000000;
+
+// Deepest iteration, passes included
+constexpr int MAX_DEPTH = 64;
+
+struct SearchLimits {
+    int depth = MAX_DEPTH;  // plies, counting the root move
+    int time_ms = 0;        // wall clock budget for the move, 0 for none
+    
+    // Solve exactly from this many empty squares down, 0 never (see EndgameSolver)
+    int endgame_empties = 0;
+    
+    /* Set from another thread to cancel the search. The result is then that of
+     * the last iteration completed, or the best of the moves solved, and the
+     * move is -1 if there was none */
+    const std::atomic<bool>* stop = nullptr;
+    
+    // Evaluates leaves with these pattern tables, nullptr for the heuristic
+    const PatternEvaluator* patterns = nullptr;
+    
+    // Prunes with Multi-ProbCut, fitted to the evaluation in use. nullptr searches every move
+    const ProbCut* probcut = nullptr;
+    
+    // Where the search publishes its progress while it runs, if anywhere
+    SearchProgress* progress = nullptr;
+};
+
+// Beta cutoffs at each ply, and how many of them the first move searched gave
+struct CutoffStats {
+    std::uint64_t cutoffs[MAX_DEPTH + 1] = {};
+    std::uint64_t first_move[MAX_DEPTH + 1] = {};
+    
+    CutoffStats& operator+=(const CutoffStats& o) noexcept;
+};
+
+struct SearchResult {
+    int move = -1;            // best square, -1 when the side to move must pass
+    int score = -SCORE_INF;   // from the point of view of the side to move
+    int depth = 0;            // plies of the last completed iteration
+    std::uint64_t nodes = 0;  // positions visited, root and leaves included
+    double time_ms = 0;       
+    std::uint64_t evals = 0;  // leaves scored by the evaluation function
+    std::vector<int> pv;      // principal variation, -1 for a pass
+    bool exact = false;       // solved: score is the final disc difference
+    CutoffStats cutoffs;      // of the main thread, to measure move ordering
+};
+
+/* Figures of a running search for a front end to show, read from another
+ * thread. Every thread of the search adds its nodes every few thousand,
+ * and the main one the result of each completed iteration (the endgame
+ * solver each better root move). reset() before the search starts */
+class SearchProgress {
+public:
+    struct Snapshot {
+        std::uint64_t nodes = 0;
+        int depth = 0;             // 0 before the first iteration completes
+        int score = 0;
+        std::vector<int> pv;
+        double time_ms = 0;        // since reset()
+    };
+    
+    void reset();
+    
+    void add_nodes(const std::uint64_t n) noexcept {nodes.fetch_add(n, std::memory_order_relaxed);}
+    void set_iteration(const int depth, const int score, const int* line, const int length) noexcept;
+    
+    Snapshot snapshot() const;
+    
+private:
+    std::atomic<std::uint64_t> nodes {0};
+    std::chrono::steady_clock::time_point start;
+    
+    mutable std::mutex mutex;
+    int depth = 0;
+    int score = 0;
+    int pv[MAX_DEPTH + 1];
+    int pv_length = 0;
+};
+
+/* Negamax search with principal variation search (alpha-beta with null
+ * windows on all but the first move). run() deepens iteratively until 
+ * the depth or time limit is reached and returns the move of the last
+ * completed iteration. Each iteration tries the previous principal
+ * variation first. run_minimax() keeps the plain full-width search as
+ * a reference to measure how many nodes the pruning saves.
+ * With a transposition table, positions reached again by another move 
+ * order are not searched twice and the best move stored for a position 
+ * is tried first. The table is not owned and may be shared by searches
+ * running on other threads (see ParallelSearch). Close to the end of the
+ * game run() hands the position over to the EndgameSolver.
+ * Moves are ordered by: the move of the previous principal variation or
+ * of the table, the two killer moves of the ply (the last ones to cause
+ * a cutoff there), then, far enough from the leaves, the fewest replies
+ * left to the opponent, and last the history table, which rewards the
+ * squares causing cutoffs anywhere in the tree by the depth squared.
+ * With ProbCut parameters, null window nodes off the principal variation
+ * are first searched shallower to cut the ones that will very likely
+ * fail high or low (see ProbCut) */
+class Search {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    explicit Search(TranspositionTable* table = nullptr) noexcept : tt{table} {}
+    
+    SearchResult run(const Position& pos, const SearchLimits& limits);
+    SearchResult run(const Position& pos, const int depth);
+    SearchResult run_minimax(const Position& pos, const int depth);
+    
+    /* Helper threads of a lazy SMP search (id > 0) search every other 
+     * iteration one ply deeper and visit the root moves in another order,
+     * so they fill the shared table with entries the main thread lacks */
+    void set_thread_id(const int id) noexcept {thread_id = id;}
+    
+    /* Building blocks of a root split search: begin() once per search, 
+     * then for each iteration begin_iteration() and search_move() on the
+     * root moves given to this thread, and finish() at the end */
+    void begin(const SearchLimits& limits, const Clock::time_point start) noexcept;
+    void begin_iteration(const int depth, const std::vector<int>& prev_line) noexcept;
+    int search_move(const Position& pos, const int sq, const int depth, const int alpha, const int beta);
+    void finish() noexcept;
+    
+    // Line of the last search_move(), the move itself first
+    std::vector<int> line() const {return std::vector<int>(pv[0], pv[0] + pv_length[0]);}
+    bool stopped() const noexcept {return aborted;}
+    std::uint64_t node_count() const noexcept {return nodes;}
+    std::uint64_t eval_count() const noexcept {return evals;}
+    const CutoffStats& cutoff_stats() const noexcept {return cutoffs;}
+    
+private:
+    /* The tree is searched by the instance of the evaluation in use,
+     * chosen once per iteration: Patterns is true with pattern tables */
+    template <bool Patterns>
+    bool search_root(const Position& pos, const int depth, SearchResult& res);
+    template <bool Patterns>
+    int pvs(const int depth, const int ply, int alpha, const int beta);
+    template <bool Patterns>
+    int minimax(const int depth);
+    
+    bool out_of_time() noexcept;
+    void publish_nodes() noexcept;
+    void update_pv(const int ply, const int move) noexcept;
+    void order_moves(MoveList& moves, const Position& pos, const int depth, const int ply, 
+                     const int preferred) const noexcept;
+    void update_ordering(const int sq, const int depth, const int ply, const int index) noexcept;
+    template <bool Patterns>
+    bool probcut_cut(const int depth, const int ply, const int alpha, const int beta, int& score);
+    
+    Board board;
+    TranspositionTable* tt;
+    TTStats tt_stats;
+    std::uint64_t nodes = 0;
+    std::uint64_t evals = 0;
+    int thread_id = 0;
+    int time_ms = 0;
+    
+    Clock::time_point deadline;
+    const std::atomic<bool>* stop = nullptr;
+    bool timed = false;
+    bool aborted = false;
+    const ProbCut* probcut = nullptr;
+    SearchProgress* progress = nullptr;
+    std::uint64_t published = 0;  // nodes already added to progress
+    
+    // Triangular table: pv[ply] is the best line found from ply onwards
+    int pv[MAX_DEPTH + 1][MAX_DEPTH + 1];
+    int pv_length[MAX_DEPTH + 1];
+    
+    // Line of the previous iteration, searched first while following it
+    int prev_pv[MAX_DEPTH + 1];
+    int prev_pv_length = 0;
+    bool follow_pv = false;
+    
+    // Move ordering, cleared by begin()
+    int killers[MAX_DEPTH + 1][2];
+    int history[NUM_SQUARES];
+    CutoffStats cutoffs;
+};
+
+} // namespace reversi
+
+#endif // REVERSI_SEARCH_HEADER
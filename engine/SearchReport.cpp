@@ -0,0 +1,64 @@
+#include <cstdio>
+
+#include "GameRecord.h"
+#include "SearchReport.h"
+
+namespace reversi {
+
+SearchReport make_report(const SearchResult& res, const TTStats& tt, const int threads)
+{
+    SearchReport r;
+    r.move = res.move;
+    r.score = res.score;
+    r.depth = res.depth;
+    r.exact = res.exact;
+    r.nodes = res.nodes;
+    r.evals = res.evals;
+    r.time_ms = res.time_ms;
+    r.pv = res.pv;
+    r.tt = tt;
+    r.threads = threads;
+    
+    for (int ply=0; ply<=MAX_DEPTH; ++ply) {
+        r.cutoffs += res.cutoffs.cutoffs[ply];
+        r.first_move_cutoffs += res.cutoffs.first_move[ply];
+    }
+    return r;
+}
+
+std::string line_string(const std::vector<int>& line)
+{
+    std::string res;
+    for (const int sq: line) {
+        if (!res.empty()) {res += ' ';}
+        res += sq < 0 ? "pass" : square_name(sq);
+    }
+    return res;
+}
+
+std::string SearchReport::to_json() const
+{
+    // Only numbers and square names: nothing to escape
+    std::string pv_json;
+    for (const int sq: pv) {
+        if (!pv_json.empty()) {pv_json += ',';}
+        pv_json += '"' + (sq < 0 ? std::string("pass") : square_name(sq)) + '"';
+    }
+    
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+                  "{\"move\":\"%s\",\"score\":%d,\"depth\":%d,\"exact\":%s,\"nodes\":%llu,\"evals\":%llu,"
+                  "\"time_ms\":%.3f,\"nps\":%.0f,\"threads\":%d,\"tt_probes\":%llu,\"tt_hits\":%llu,"
+                  "\"tt_hit_rate\":%.4f,\"tt_stores\":%llu,\"tt_replacements\":%llu,\"cutoffs\":%llu,"
+                  "\"first_move_cutoff_rate\":%.4f,\"pv\":[",
+                  move < 0 ? "pass" : square_name(move).c_str(), score, depth, exact ? "true" : "false",
+                  static_cast<unsigned long long>(nodes), static_cast<unsigned long long>(evals),
+                  time_ms, nps(), threads, static_cast<unsigned long long>(tt.probes),
+                  static_cast<unsigned long long>(tt.hits), tt.hit_rate(),
+                  static_cast<unsigned long long>(tt.stores), static_cast<unsigned long long>(tt.replacements),
+                  static_cast<unsigned long long>(cutoffs), first_move_rate());
+    
+    return buf + pv_json + "]}";
+}
+
+} // namespace reversi
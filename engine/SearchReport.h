@@ -0,0 +1,46 @@
+#ifndef REVERSI_SEARCH_REPORT_HEADER
+#define REVERSI_SEARCH_REPORT_HEADER
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Search.h"
+#include "TranspositionTable.h"
+
+namespace reversi {
+
+/* What one search did, for the status bar of the game and for logs
+ * that follow the speed of the engine from one version to the next.
+ * Counts are summed over all threads, cutoffs over the main one */
+struct SearchReport {
+    int move = -1;
+    int score = 0;
+    int depth = 0;
+    bool exact = false;            // solved to the end of the game
+    std::uint64_t nodes = 0;
+    std::uint64_t evals = 0;       // leaves scored by the evaluation function
+    double time_ms = 0;
+    std::vector<int> pv;
+    TTStats tt;
+    std::uint64_t cutoffs = 0;
+    std::uint64_t first_move_cutoffs = 0;
+    int threads = 1;
+    
+    double nps() const noexcept {return time_ms > 0 ? nodes * 1000.0 / time_ms : 0.0;}
+    
+    // Share of the cutoffs given by the first move searched
+    double first_move_rate() const noexcept {return cutoffs ? double(first_move_cutoffs) / cutoffs : 0.0;}
+    
+    // One JSON object on a single line, without the newline
+    std::string to_json() const;
+};
+
+SearchReport make_report(const SearchResult& res, const TTStats& tt, const int threads);
+
+// Moves like "f5 d6 pass c3"
+std::string line_string(const std::vector<int>& line);
+
+} // namespace reversi
+
+#endif // REVERSI_SEARCH_REPORT_HEADER
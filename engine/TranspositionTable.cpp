@@ -0,0 +1,162 @@
+#include <new>
+
+#include "TranspositionTable.h"
+
+namespace reversi {
+
+namespace {
+
+const std::size_t CACHE_LINE = 64;
+
+// data layout: score (32 bits) | move (8) | depth (8) | bound (8) | age (8)
+inline std::uint64_t pack(const int score, const int move, const int depth,
+                          const Bound bound, const std::uint8_t age) noexcept
+{
+    return  static_cast<std::uint64_t>(static_cast<std::uint32_t>(score))      |
+           (static_cast<std::uint64_t>(static_cast<std::uint8_t>(move)) << 32)  |
+           (static_cast<std::uint64_t>(static_cast<std::uint8_t>(depth)) << 40) |
+           (static_cast<std::uint64_t>(bound) << 48)                            |
+           (static_cast<std::uint64_t>(age) << 56);
+}
+
+inline Bound bound_of(const std::uint64_t data) noexcept
+{
+    return static_cast<Bound>((data >> 48) & 0xFF);
+}
+
+inline int depth_of(const std::uint64_t data) noexcept {return (data >> 40) & 0xFF;}
+inline std::uint8_t age_of(const std::uint64_t data) noexcept {return data >> 56;}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(const std::size_t size_mb)
+{
+    resize(size_mb);
+}
+
+void TranspositionTable::resize(const std::size_t size_mb)
+{
+    const std::size_t bytes = (size_mb ? size_mb : 1) << 20;
+    
+    std::size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= bytes) {count *= 2;}
+    
+    // One bucket per cache line
+    void* mem = nullptr;
+    if (posix_memalign(&mem, CACHE_LINE, count * sizeof(Bucket)) != 0) {
+        throw std::bad_alloc();
+    }
+    
+    Bucket* b = static_cast<Bucket*>(mem);
+    for (std::size_t i=0; i<count; ++i) {
+        new (b + i) Bucket;
+    }
+    
+    buckets.reset(b);
+    mask = count - 1;
+    clear();
+    reset_stats();
+}
+
+void TranspositionTable::clear() noexcept
+{
+    Bucket* b = buckets.get();
+    
+    for (std::uint64_t i=0; i<=mask; ++i) {
+        for (auto& s: b[i].entries) {
+            s.check.store(0, std::memory_order_relaxed);
+            s.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    age.store(0, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::probe(const std::uint64_t key, TTEntry& entry) const noexcept
+{
+    for (const auto& s: buckets.get()[key & mask].entries) {
+        const std::uint64_t data = s.data.load(std::memory_order_relaxed);
+        const std::uint64_t check = s.check.load(std::memory_order_relaxed);
+        
+        if ((check ^ data) == key && bound_of(data) != Bound::none) {
+            entry.key = key;
+            entry.score = static_cast<std::int32_t>(static_cast<std::uint32_t>(data));
+            entry.move = static_cast<std::int8_t>((data >> 32) & 0xFF);
+            entry.depth = depth_of(data);
+            entry.bound = bound_of(data);
+            entry.age = age_of(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TranspositionTable::store(const std::uint64_t key,
+                               const int depth,
+                               const int score,
+                               const Bound bound,
+                               const int move) noexcept
+{
+    const std::uint8_t current = age.load(std::memory_order_relaxed);
+    Slot* victim = nullptr;
+    std::uint64_t victim_data = 0;
+    int victim_priority = 0;
+    
+    for (auto& s: buckets.get()[key & mask].entries) {
+        const std::uint64_t data = s.data.load(std::memory_order_relaxed);
+        const std::uint64_t check = s.check.load(std::memory_order_relaxed);
+        
+        if ((check ^ data) == key && bound_of(data) != Bound::none) {
+            // Same position: keep a deeper result from this search
+            if (age_of(data) == current && depth_of(data) > depth && bound != Bound::exact) {
+                return false;
+            }
+            victim = &s;
+            victim_data = 0; // not an eviction
+            break;
+        }
+        
+        // Empty entries first, then older searches, then shallower entries
+        const int priority = bound_of(data) == Bound::none ? -1 
+                           : (age_of(data) == current ? 256 : 0) + depth_of(data);
+        
+        if (!victim || priority < victim_priority) {
+            victim = &s;
+            victim_data = data;
+            victim_priority = priority;
+        }
+    }
+    
+    const std::uint64_t data = pack(score, move, depth, bound, current);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->check.store(key ^ data, std::memory_order_relaxed);
+    
+    return bound_of(victim_data) != Bound::none;
+}
+
+void TranspositionTable::record(const TTStats& st) noexcept
+{
+    probes.fetch_add(st.probes, std::memory_order_relaxed);
+    hits.fetch_add(st.hits, std::memory_order_relaxed);
+    stores.fetch_add(st.stores, std::memory_order_relaxed);
+    replacements.fetch_add(st.replacements, std::memory_order_relaxed);
+}
+
+TTStats TranspositionTable::stats() const noexcept
+{
+    TTStats st;
+    st.probes = probes.load(std::memory_order_relaxed);
+    st.hits = hits.load(std::memory_order_relaxed);
+    st.stores = stores.load(std::memory_order_relaxed);
+    st.replacements = replacements.load(std::memory_order_relaxed);
+    return st;
+}
+
+void TranspositionTable::reset_stats() noexcept
+{
+    probes.store(0, std::memory_order_relaxed);
+    hits.store(0, std::memory_order_relaxed);
+    stores.store(0, std::memory_order_relaxed);
+    replacements.store(0, std::memory_order_relaxed);
+}
+
+} // namespace reversi
@@ -0,0 +1,96 @@
+#ifndef REVERSI_TRANSPOSITION_TABLE_HEADER
+#define REVERSI_TRANSPOSITION_TABLE_HEADER
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+namespace reversi {
+
+// How the stored score relates to the real one
+enum class Bound : std::uint8_t {
+    none=0, upper, lower, exact
+};
+
+struct TTEntry {
+    std::uint64_t key = 0;
+    std::int32_t score = 0;
+    std::int8_t move = -1;      // best square found, -1 if none
+    std::uint8_t depth = 0;     // remaining plies the score was searched to
+    Bound bound = Bound::none;  // none marks an empty slot
+    std::uint8_t age = 0;       // search generation that stored it
+};
+
+struct TTStats {
+    std::uint64_t probes = 0;
+    std::uint64_t hits = 0;
+    std::uint64_t stores = 0;
+    std::uint64_t replacements = 0;  // stores that evicted another position
+    
+    std::uint64_t misses() const noexcept {return probes - hits;}
+    double hit_rate() const noexcept {return probes ? double(hits) / probes : 0.0;}
+};
+
+/* Fixed size hash table of searched positions, shared without locks by 
+ * the threads of a parallel search. Entries are grouped in buckets of
+ * four that fill one cache line. A bucket keeps the deepest entries of
+ * the current search and evicts those of older searches first.
+ * Each slot holds the packed entry and its key xored with it, so a slot
+ * torn by two threads writing at once fails the key check on probe.
+ * Searches count their own probes and hits and add them with record() */
+class TranspositionTable {
+    struct Slot {
+        std::atomic<std::uint64_t> check;  // key ^ data
+        std::atomic<std::uint64_t> data;
+    };
+    
+    struct Bucket {
+        Slot entries[4];
+    };
+    
+    struct FreeDeleter {
+        void operator()(void* p) const noexcept {std::free(p);}
+    };
+    
+    std::unique_ptr<Bucket, FreeDeleter> buckets;
+    std::uint64_t mask = 0;
+    std::atomic<std::uint8_t> age {0};
+    
+    std::atomic<std::uint64_t> probes {0}, hits {0}, stores {0}, replacements {0};
+    
+public:
+    static const std::size_t DEFAULT_SIZE_MB = 64;
+    
+    explicit TranspositionTable(const std::size_t size_mb = DEFAULT_SIZE_MB);
+    
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+    
+    // Resizes to the largest power of two number of buckets within size_mb. Clears the table
+    void resize(const std::size_t size_mb);
+    void clear() noexcept;
+    
+    // Call before each new search so entries of the previous ones get replaced first
+    void new_search() noexcept {age.fetch_add(1, std::memory_order_relaxed);}
+    
+    bool probe(const std::uint64_t key, TTEntry& entry) const noexcept;
+    
+    // Returns true if another position was evicted to make room
+    bool store(const std::uint64_t key,
+               const int depth,
+               const int score,
+               const Bound bound,
+               const int move) noexcept;
+    
+    std::size_t size_bytes() const noexcept {return (mask + 1) * sizeof(Bucket);}
+    
+    void record(const TTStats& st) noexcept;
+    TTStats stats() const noexcept;
+    void reset_stats() noexcept;
+};
+
+} // namespace reversi
+
+#endif // REVERSI_TRANSPOSITION_TABLE_HEADER
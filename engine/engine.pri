@@ -0,0 +1,7 @@
+# Included by the projects using the engine: its headers and the static library
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+ENGINE_LIB_DIR = $$shadowed($$PWD)
+LIBS += -L$$ENGINE_LIB_DIR -lreversi_engine
+PRE_TARGETDEPS += $$ENGINE_LIB_DIR/libreversi_engine.a
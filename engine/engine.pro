@@ -0,0 +1,40 @@
+# Qt-free game engine: bitboard positions, move generation, evaluation and search
+TEMPLATE = lib
+TARGET = reversi_engine
+CONFIG += staticlib release
+CONFIG -= qt
+
+HEADERS += Position.h \
+           Board.h \
+           MoveList.h \
+           Evaluation.h \
+           Patterns.h \
+           Search.h \
+           SearchReport.h \
+           ParallelSearch.h \
+           Analysis.h \
+           Endgame.h \
+           MonteCarlo.h \
+           ProbCut.h \
+           TranspositionTable.h \
+           GameRecord.h \
+           OpeningBook.h \
+           Engine.h
+
+SOURCES += Position.cpp \
+           Board.cpp \
+           Evaluation.cpp \
+           Patterns.cpp \
+           Search.cpp \
+           SearchReport.cpp \
+           ParallelSearch.cpp \
+           Analysis.cpp \
+           Endgame.cpp \
+           MonteCarlo.cpp \
+           ProbCut.cpp \
+           TranspositionTable.cpp \
+           GameRecord.cpp \
+           OpeningBook.cpp \
+           Engine.cpp
+
+QMAKE_CXXFLAGS += -std=c++14 -pthread
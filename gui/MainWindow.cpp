@@ -0,0 +1,869 @@
+#include <QString>
+#include <QMessageBox>
+#include <QInputDialog>
+#include <QtConcurrentRun>
+#include <algorithm>
+
+#include "MainWindow.h"
+
+using reversi::Bitboard;
+using reversi::Position;
+using reversi::bit;
+using reversi::square;
+
+MainWindow::MainWindow(QMainWindow* parent)
+    : QMainWindow(parent), 
+      ui{std::make_unique<Ui::MainWindow>()},
+      signalMapper{new QSignalMapper(this)},
+      btn_storage(SIZE, std::vector<QPushButton*>(SIZE, nullptr)),
+      engine(this->seeder())
+{
+    ui->setupUi(this);
+    
+    // Put pieces on central cells
+    // Black is Minimizer player, W is Maximizer
+    const Bitboard white_discs = position(true).player, black_discs = position(false).player;
+    
+    // Make icons
+    black.addPixmap(QPixmap("icons/black.png"), QIcon::Disabled);
+    white.addPixmap(QPixmap("icons/white.png"), QIcon::Disabled);
+    
+    
+    // Create buttons
+    for (int i=0; i<SIZE; ++i) {
+        for (int j=0; j<SIZE; ++j) {
+            QPushButton* btn = new QPushButton(ui->centralwidget);
+            btn->setMinimumWidth(64);
+            btn->setMinimumHeight(64);
+            btn->setAttribute(Qt::WA_LayoutUsesWidgetRect);
+            btn->setIconSize(QSize(48, 48));
+            
+            if (white_discs & bit(square(i, j))) {
+                btn->setIcon(white);
+                btn->setEnabled(false);
+            }
+            else if (black_discs & bit(square(i, j))) {
+                btn->setIcon(black);
+                btn->setEnabled(false);
+            }
+            
+            ui->gridLayout->addWidget(btn, i, j);
+            QString coordinates = QString::number(i)+","+QString::number(j); //Coordinate of the button
+            signalMapper->setMapping(btn, coordinates);
+            
+            connect(btn, SIGNAL(clicked()), signalMapper, SLOT(map()));
+            
+            btn_storage[i][j] = btn; // store pointer on array for easy retrieval
+        }
+    }
+    
+    connect(signalMapper, SIGNAL(mapped(QString)), this, SLOT(buttonClicked(QString)));
+    
+    // Statusbar
+    update_scores();
+    lab.setStyleSheet("font-weight: bold; color: black");
+    ui->statusbar->addPermanentWidget(&lab);
+    update_status_bar();
+    
+    // Searches run on a worker thread and report back through the event loop
+    connect(&watcher, SIGNAL(finished()), this, SLOT(search_finished()));
+    
+    progress_timer.setInterval(200);
+    connect(&progress_timer, SIGNAL(timeout()), this, SLOT(show_progress()));
+}
+
+MainWindow::~MainWindow()
+{
+    cancel_search();
+}
+
+void MainWindow::set_hash_size(const std::size_t size_mb)
+{
+    computer.set_hash_size(size_mb);
+}
+
+void MainWindow::set_threads(const int num_threads, const reversi::ParallelMode mode)
+{
+    computer.set_threads(num_threads, mode);
+}
+
+void MainWindow::set_pattern_evaluation(const bool enable)
+{
+    computer.set_pattern_evaluation(enable);
+}
+
+bool MainWindow::set_pattern_weights(const std::string& path)
+{
+    return computer.load_weights(path);
+}
+
+bool MainWindow::set_opening_book(const std::string& path)
+{
+    return computer.open_book(path);
+}
+
+bool MainWindow::set_probcut(const std::string& path)
+{
+    return computer.load_probcut(path);
+}
+
+void MainWindow::set_endgame_empties(const int empties)
+{
+    endgame_empties = empties;
+}
+
+bool MainWindow::set_search_log(const std::string& path)
+{
+    search_log.open(path, std::ios::app);
+    return search_log.is_open();
+}
+
+void MainWindow::buttonClicked(QString coordinates)
+{    
+    if (thinking) {return;} // wait for the computer
+    
+    QStringList results = coordinates.split(",");
+    int row = results.at(0).toInt();
+    int col = results.at(1).toInt();
+    
+    if (!is_valid_move(row, col, false)) {
+        QMessageBox::warning(this, "Invalid", "Invalid move");
+        return;
+    }
+    
+    stop_analysis();
+    
+    // Your turn 
+    make_move(row, col, false); // make move
+    reply_start = std::chrono::steady_clock::now();
+    
+    // The ponder search is of use only if it guessed this move
+    const bool hit = ponder != Ponder::off && position(true) == ponder_pos;
+    if (!hit) {stop_ponder();}
+    
+    update_icons();
+    update_scores();
+    update_status_bar();
+    
+    if (check_end() || (!has_moves_available(true) && !has_moves_available(false))) {
+        block_all_cells();
+        show_result();
+        return;
+    }
+    
+    if (!has_moves_available(true)) { // if computer has no moves available play again
+        QMessageBox::information(this, "Play again", "Computer has no moves available.\n Play again.");
+        player_turn(reversi::SearchResult());
+        return;
+    }
+    
+    // Computer turn
+    if (hit) {take_ponder();}
+    else {start_search(Task::computer_move);}
+}
+
+/* Computer moves and hints are searched on a worker thread so the 
+ * window stays responsive. Only one search runs at a time */
+void MainWindow::start_search(const Task t)
+{
+    task = t;
+    thinking = true;
+    stop_search = false;
+    ponder_hit = false;
+    
+    ui->statusbar->showMessage("Thinking...");
+    progress.reset();
+    progress_timer.start();
+    
+    if (t == Task::hint) {
+        const Position pos = position(false);
+        watcher.setFuture(QtConcurrent::run([this, pos]() {return computer_move_intermediate(pos);}));
+    }
+    else {
+        const Position pos = position(true);
+        watcher.setFuture(QtConcurrent::run([this, pos]() {return computer_move(pos);}));
+    }
+}
+
+/* Asks the running search to stop and waits for it, which takes at 
+ * most a few thousand nodes. Its result is dropped, and so are the
+ * ponder search and the analysis */
+void MainWindow::cancel_search()
+{
+    stop_ponder();
+    stop_analysis();
+    if (!thinking) {return;}
+    
+    stop_search = true;
+    watcher.waitForFinished();
+    thinking = false;
+    progress_timer.stop();
+    ui->statusbar->clearMessage();
+}
+
+void MainWindow::search_finished()
+{
+    // A stale signal while the next search runs
+    if (!watcher.isFinished()) {return;}
+    
+    // Every move searched to the end of the game
+    if (analyzing) {
+        analyzing = false;
+        progress_timer.stop();
+        show_analysis();
+        
+        const reversi::SearchResult res = watcher.result();
+        ui->statusbar->showMessage("Analysis done, depth " + QString::number(res.depth) + ", " +
+                                   QString::number(res.nodes) + " nodes, " +
+                                   QString::number(res.time_ms / 1000, 'f', 2) + " s");
+        return;
+    }
+    
+    // Kept until the player moves
+    if (ponder == Ponder::running) {
+        ponder = Ponder::done;
+        ponder_result = watcher.result();
+        return;
+    }
+    
+    if (!thinking) {return;} // cancelled
+    
+    thinking = false;
+    progress_timer.stop();
+    play_result(watcher.result());
+}
+
+// Shows a hint, or plays the computer move and ponders on the reply
+void MainWindow::play_result(const reversi::SearchResult& res)
+{
+    const int row = reversi::row_of(res.move), col = reversi::col_of(res.move);
+    
+    if (ponder_hit) {
+        const auto waited = std::chrono::steady_clock::now() - reply_start;
+        const long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(waited).count();
+        show_search_stats(res, "Ponder hit, replied in " + QString::number(ms) + " ms. ");
+    }
+    else {
+        show_search_stats(res);
+    }
+    
+    if (task == Task::hint) {
+        player_turn(last_move); // the hint search stopped the ponder search or the analysis
+        QString msg = "Try coordinates ("+QString::number(row)+","+QString::number(col)+")";
+        QMessageBox::information(this, "Hint", msg);
+        return;
+    }
+    
+    last_move = res;
+    make_move(row, col, true);
+    update_icons();
+    update_scores();
+    update_status_bar();
+    
+    if (check_end() || (!has_moves_available(true) && !has_moves_available(false))) {
+        block_all_cells();
+        show_result();
+        return;
+    }
+    
+    // if player has no moves available computer plays again
+    if (!has_moves_available(false)) {
+        start_search(Task::computer_move);
+    }
+    else {
+        player_turn(res);
+    }
+}
+
+// Analysis or pondering while the player thinks, last being the computer move before
+void MainWindow::player_turn(const reversi::SearchResult& last)
+{
+    if (analysis_enabled) {start_analysis();}
+    else {start_ponder(last);}
+}
+
+/* Searches the position after the reply the computer expects, the
+ * second move of the line of its last search. Book moves and the
+ * beginner level have no line, so they don't ponder. The search is 
+ * the one the computer move would make, only started earlier */
+void MainWindow::start_ponder(const reversi::SearchResult& res)
+{
+    if (!pondering_enabled || level == Level::beginner || res.pv.size() < 2) {return;}
+    
+    const Position mine = position(false);
+    const int expected = res.pv[1];
+    if (expected < 0 || !mine.is_legal(expected)) {return;}
+    
+    const Position next = mine.play(expected);
+    if (!next.has_moves()) {return;} // the computer would pass
+    
+    ponder = Ponder::running;
+    ponder_pos = next;
+    stop_search = false;
+    progress.reset();
+    watcher.setFuture(QtConcurrent::run([this, next]() {return computer_move(next);}));
+}
+
+/* The player made the expected move. The ponder search has had the
+ * player's time as a head start: its result is played now if it has
+ * ended, or as the computer move when it does */
+void MainWindow::take_ponder()
+{
+    task = Task::computer_move;
+    ponder_hit = true;
+    
+    if (ponder == Ponder::done) {
+        ponder = Ponder::off;
+        play_result(ponder_result);
+        return;
+    }
+    
+    ponder = Ponder::off;
+    thinking = true;
+    ui->statusbar->showMessage("Thinking...");
+    progress_timer.start();
+}
+
+// Stops the ponder search if it runs and forgets its result
+void MainWindow::stop_ponder()
+{
+    if (ponder == Ponder::running) {
+        stop_search = true;
+        watcher.waitForFinished();
+    }
+    ponder = Ponder::off;
+}
+
+void MainWindow::set_pondering(const bool enable)
+{
+    ui->action_Ponder->setChecked(enable); // toggled() calls toggle_pondering
+}
+
+void MainWindow::toggle_pondering(bool enable)
+{
+    pondering_enabled = enable;
+    if (!enable) {stop_ponder();}
+}
+
+void MainWindow::toggle_analysis(bool enable)
+{
+    analysis_enabled = enable;
+    if (enable) {start_analysis();}
+    else {stop_analysis();}
+}
+
+/* Scores the moves of the player until the end of the game, unless
+ * the player moves first */
+void MainWindow::start_analysis()
+{
+    if (!analysis_enabled || thinking || analyzing || white_to_move() || !has_moves_available(false)) {return;}
+    
+    stop_ponder(); // one search at a time
+    clear_analysis();
+    
+    analyzing = true;
+    stop_search = false;
+    progress.reset();
+    analysis.reset();
+    progress_timer.start();
+    
+    const Position pos = position(false);
+    watcher.setFuture(QtConcurrent::run([this, pos]() {return computer_analysis(pos);}));
+}
+
+// Stops the analysis if it runs and takes its scores off the board
+void MainWindow::stop_analysis()
+{
+    if (analyzing) {
+        stop_search = true;
+        watcher.waitForFinished();
+        analyzing = false;
+        progress_timer.stop();
+        ui->statusbar->clearMessage();
+    }
+    clear_analysis();
+}
+
+/* The score of each move on its square: the final disc difference once 
+ * solved, else the evaluation of the player. The best one is marked,
+ * and the tooltip has the depth and the line */
+void MainWindow::show_analysis()
+{
+    const std::vector<reversi::MoveScore> scores = analysis.snapshot();
+    
+    for (std::size_t i=0; i<scores.size(); ++i) {
+        const reversi::MoveScore& m = scores[i];
+        QString text;
+        if (m.exact) {text = (m.score > 0 ? "+" : "") + QString::number(m.score);}
+        else if (m.score >= reversi::SCORE_WIN) {text = "win";}
+        else if (m.score <= -reversi::SCORE_WIN) {text = "loss";}
+        else {text = QString::number(m.score);}
+        if (i == 0) {text = "*" + text;}
+        
+        QPushButton* btn = btn_storage[reversi::row_of(m.move)][reversi::col_of(m.move)];
+        btn->setText(text);
+        btn->setToolTip("Depth " + QString::number(m.depth) + ", line " +
+                        QString::fromStdString(reversi::line_string(m.pv)));
+    }
+}
+
+void MainWindow::clear_analysis()
+{
+    for (auto& row: btn_storage) {
+        for (auto& btn: row) {
+            btn->setText("");
+            btn->setToolTip("");
+        }
+    }
+}
+
+void MainWindow::show_result()
+{
+    if (my_score > computer_score) {
+        QMessageBox::information(this, "Congratulations", "You Win!!!");
+    }
+    else if (my_score < computer_score) {
+        QMessageBox::warning(this, "Ouch!", "You Loose!!");
+    }
+    else {
+        QMessageBox::warning(this, "Ouch!", "DRAW!!!");
+    }
+}
+
+// What the running search has found so far
+void MainWindow::show_progress()
+{
+    if (!thinking && !analyzing) {return;}
+    if (analyzing) {show_analysis();}
+    
+    const reversi::SearchProgress::Snapshot snap = progress.snapshot();
+    if (snap.nodes == 0) {return;}
+    
+    QString msg = analyzing ? "Analyzing... " : "Thinking... ";
+    if (snap.depth > 0) {
+        msg += "depth " + QString::number(snap.depth) + ", " +
+               "line " + QString::fromStdString(reversi::line_string(snap.pv)) + ", ";
+    }
+    msg += QString::number(snap.nodes) + " nodes, " +
+           QString::number(snap.time_ms > 0 ? snap.nodes / snap.time_ms : 0.0, 'f', 0) + " knodes/s";
+    ui->statusbar->showMessage(msg);
+}
+
+void MainWindow::show_search_stats(const reversi::SearchResult& res, const QString& prefix)
+{
+    if (res.depth == 0) { // beginner level and book moves do not search
+        if (level == Level::beginner) {ui->statusbar->clearMessage();}
+        else {ui->statusbar->showMessage(prefix + "Opening book move");}
+        return;
+    }
+    
+    if (level == Level::monte_carlo && task == Task::computer_move) {
+        const reversi::MonteCarloStats st = computer.monte_carlo_stats();
+        ui->statusbar->showMessage(prefix + "Monte Carlo, " + QString::number(st.playouts) + " playouts, " +
+                                   QString::number(st.playouts_per_second_per_core() / 1000, 'f', 1) +
+                                   " kplayouts/s per core, " +
+                                   "win rate " + QString::number((res.score + 1000) / 20.0, 'f', 1) + "%, " +
+                                   QString::number(st.reused) + " visits kept, line " +
+                                   QString::fromStdString(reversi::line_string(res.pv)));
+        return;
+    }
+    
+    const reversi::SearchReport report = computer.report(res);
+    log_search(report);
+    
+    const QString figures = QString::number(report.nodes) + " nodes, " +
+                            QString::number(report.evals) + " evaluations, " +
+                            QString::number(report.nps() / 1000, 'f', 0) + " knodes/s, " +
+                            QString::number(report.time_ms / 1000, 'f', 2) + " s, " +
+                            "hash hits " + QString::number(100 * report.tt.hit_rate(), 'f', 1) + "%";
+    
+    if (res.exact) {
+        const QString outcome = res.score > 0 ? "win by " + QString::number(res.score) + " discs"
+                              : res.score < 0 ? "loss by " + QString::number(-res.score) + " discs"
+                              : QString("draw");
+        ui->statusbar->showMessage(prefix + "Solved, " + outcome + " with best play, " + figures);
+        return;
+    }
+    
+    ui->statusbar->showMessage(prefix + "Depth " + QString::number(res.depth) + ", " + figures + ", " +
+                               "first move cutoffs " + QString::number(100 * report.first_move_rate(), 'f', 1) +
+                               "%, line " + QString::fromStdString(reversi::line_string(report.pv)));
+}
+
+// One line per search: the game context, then the report
+void MainWindow::log_search(const reversi::SearchReport& report)
+{
+    if (!search_log.is_open()) {return;}
+    
+    static const char* const levels[] = {"beginner", "intermediate", "expert", "timed", "monte_carlo"};
+    search_log << "{\"task\":\"" << (task == Task::hint ? "hint" : "move") << "\","
+               << "\"level\":\"" << levels[static_cast<int>(level)] << "\","
+               << "\"ponder_hit\":" << (ponder_hit ? "true" : "false") << ","
+               << "\"ply\":" << board.plies() << ","
+               << "\"empties\":" << board.position().num_empties() << ","
+               << "\"search\":" << report.to_json() << "}" << std::endl;
+}
+
+/* Bitboards of the side to move first. Black is Minimizer 
+ * player, W is Maximizer */
+inline Position MainWindow::position(const bool isMax) const noexcept
+{
+    const Position& pos = board.position();
+    if (isMax == white_to_move()) {return pos;}
+    else {return Position{pos.opponent, pos.player};}
+}
+
+bool MainWindow::is_valid_move(const int row, 
+                               const int col, 
+                               const bool isMax) const noexcept
+{
+    return position(isMax).is_legal(square(row, col));
+}
+
+inline void MainWindow::update_icons()
+{
+    static const QIcon empty = QIcon();
+    const Bitboard white_discs = position(true).player, black_discs = position(false).player;
+    
+    for (int i=0; i<SIZE; ++i) {
+        for (int j=0; j<SIZE; ++j) {
+            if (white_discs & bit(square(i, j))) {
+                QPushButton* btn_pushed = btn_storage[i][j];
+                btn_pushed->setIcon(white);
+                btn_pushed->setEnabled(false);
+            }
+            else if (black_discs & bit(square(i, j))) {
+                QPushButton* btn_pushed = btn_storage[i][j];
+                btn_pushed->setIcon(black);
+                btn_pushed->setEnabled(false);
+            }
+            else { // emptied by undo or a new game
+                QPushButton* btn_pushed = btn_storage[i][j];
+                btn_pushed->setIcon(empty);
+                btn_pushed->setEnabled(true);
+            }
+        }
+    }
+}
+
+void MainWindow::make_move(const int row, 
+                           const int col, 
+                           const bool isMax)
+{   
+    // A side that plays twice in a row had the other one pass
+    if (isMax != white_to_move()) {board.make_pass();}
+    
+    // Put piece on its place and flip the outflanked ones
+    board.make(square(row, col));
+}
+
+bool MainWindow::has_moves_available(const bool isMax) const noexcept
+{
+    return position(isMax).has_moves();
+}
+
+
+void MainWindow::newGame()
+{
+    cancel_search();
+    
+    board.reset(Position::initial());
+    computer.new_game();
+    last_move = reversi::SearchResult();
+    
+    update_icons();
+    update_scores();
+    update_status_bar();
+    player_turn(last_move);
+}
+
+/* Takes back moves up to the last one of the player, computer replies
+ * and passes included. Only the flipped discs of each move are undone */
+void MainWindow::undo()
+{
+    cancel_search();
+    if (board.plies() == 0) {return;}
+    
+    do {
+        board.unmake();
+    } while (board.plies() > 0 && (white_to_move() || !has_moves_available(false)));
+    
+    resume_game();
+}
+
+// Plays again the moves taken back by the last undo
+void MainWindow::redo()
+{
+    if (thinking || !board.can_redo()) {return;}
+    cancel_search(); // the ponder search or the analysis
+    
+    do {
+        board.redo();
+    } while (board.can_redo() && (white_to_move() || !has_moves_available(false)));
+    
+    resume_game();
+}
+
+/* Shows the board after undo or redo, and lets the computer reply if 
+ * the moves stop after one of the player */
+void MainWindow::resume_game()
+{
+    update_icons();
+    update_scores();
+    update_status_bar();
+    ui->statusbar->clearMessage();
+    last_move = reversi::SearchResult(); // its reply was for another position
+    
+    if (!has_moves_available(true) && !has_moves_available(false)) {
+        block_all_cells();
+        return;
+    }
+    
+    if (white_to_move() && has_moves_available(true)) {
+        start_search(Task::computer_move);
+    }
+    else {
+        player_turn(last_move);
+    }
+}
+
+void MainWindow::set_beginner_level()
+{
+    cancel_search();
+    level = Level::beginner;
+    newGame();
+}
+
+void MainWindow::set_intermediate_level()
+{
+    cancel_search();
+    level = Level::intermediate;
+    newGame();
+}
+
+void MainWindow::set_expert_level()
+{
+    cancel_search();
+    level = Level::expert;
+    newGame();
+}
+
+void MainWindow::set_timed_level()
+{
+    bool ok = false;
+    const int ms = QInputDialog::getInt(this, "Time per move", 
+                                        "Milliseconds per computer move:",
+                                        time_per_move, 10, 600000, 100, &ok);
+    if (!ok) {return;}
+    
+    cancel_search();
+    time_per_move = ms;
+    level = Level::timed;
+    newGame();
+}
+
+// Monte Carlo tree search, with the same time per move as the timed level
+void MainWindow::set_monte_carlo_level()
+{
+    bool ok = false;
+    const int ms = QInputDialog::getInt(this, "Monte Carlo", 
+                                        "Milliseconds per computer move:",
+                                        time_per_move, 10, 600000, 100, &ok);
+    if (!ok) {return;}
+    
+    cancel_search();
+    time_per_move = ms;
+    level = Level::monte_carlo;
+    newGame();
+}
+
+inline void MainWindow::block_all_cells()
+{
+    for (auto& row: btn_storage) {
+        for (auto& btn: row) {
+            btn->setEnabled(false);
+        }
+    }
+}
+
+inline void MainWindow::update_scores() noexcept
+{
+    my_score = reversi::popcount(position(false).player);
+    computer_score = reversi::popcount(position(true).player);
+}
+
+inline void MainWindow::update_status_bar()
+{
+    QString lev;
+    switch (level) {
+        case Level::beginner:
+            lev = "Beginner";
+            break;
+        case Level::intermediate:
+            lev = "Intermediate";
+            break;
+        case Level::expert:
+            lev = "Expert";
+            break;
+        case Level::timed:
+            lev = QString::number(time_per_move) + " ms";
+            break;
+        case Level::monte_carlo:
+            lev = "Monte Carlo " + QString::number(time_per_move) + " ms";
+            break;
+        default:
+            lev = "Invalid";
+            break;
+    }
+    
+    lab.setText("Level: " + lev + "      " +
+                "Player: " + QString::number(my_score)+
+                "    Computer: " + QString::number(computer_score)+ "   ");
+}
+
+bool MainWindow::check_end() const noexcept
+{
+    if (my_score == 0) {
+        return true;
+    }
+    if (computer_score == 0) {
+        return true;
+    }
+    
+    // If all cells are filled its endgame also
+    return board.position().empties() == 0;
+}
+
+/* This just dispatches to the suitable function according to
+ * the difficulty level. Could have used inheritance and polymorphism
+ * but found it simpler this way */
+reversi::SearchResult MainWindow::computer_move(const Position& pos)
+{
+    // Known openings are played from the book, except by the beginner
+    if (level != Level::beginner) {
+        reversi::SearchResult res;
+        res.move = computer.book_move(pos);
+        if (res.move >= 0) {return res;}
+    }
+    
+    switch(level) {
+        case Level::beginner:
+            return computer_move_beginner(pos);
+        case Level::intermediate:
+            return computer_move_intermediate(pos);
+        case Level::expert:
+            return computer_move_expert(pos);
+        case Level::timed:
+            return computer_move_timed(pos);
+        case Level::monte_carlo:
+            return computer_move_monte_carlo(pos);
+        default:
+            return computer_move_expert(pos);
+    }
+}
+
+/* This is the begginer level function, which returns a random move
+ * from the set of moves available */
+reversi::SearchResult MainWindow::computer_move_beginner(const Position& pos)
+{
+    Bitboard moves_choice = pos.moves();
+    std::uniform_int_distribution<int> dist (0, reversi::popcount(moves_choice)-1);
+    
+    // drop the lowest moves until the chosen one is first
+    for (int n = dist(engine); n > 0; --n) {
+        moves_choice &= moves_choice - 1;
+    }
+    
+    reversi::SearchResult res;
+    res.move = reversi::first_square(moves_choice);
+    return res;
+}
+
+reversi::SearchResult MainWindow::computer_move_intermediate(const Position& pos)
+{
+    reversi::SearchLimits limits;
+    limits.depth = 3;
+    return computer_move_search(pos, limits);
+}
+
+reversi::SearchResult MainWindow::computer_move_expert(const Position& pos) 
+{
+    reversi::SearchLimits limits;
+    limits.depth = 5;
+    limits.endgame_empties = endgame_empties;
+    return computer_move_search(pos, limits);
+}
+
+/* Searches as deep as the time per move allows. Like the expert
+ * level it plays the endgame perfectly, whatever time that takes */
+reversi::SearchResult MainWindow::computer_move_timed(const Position& pos)
+{
+    reversi::SearchLimits limits;
+    limits.time_ms = time_per_move;
+    limits.endgame_empties = endgame_empties;
+    return computer_move_search(pos, limits);
+}
+
+/* Playouts for the time per move. The tree of the previous move is
+ * kept for this one, and dropped by New Game */
+reversi::SearchResult MainWindow::computer_move_monte_carlo(const Position& pos)
+{
+    reversi::SearchLimits limits;
+    limits.time_ms = time_per_move;
+    limits.stop = &stop_search;
+    limits.progress = &progress;
+    return computer.monte_carlo(pos, limits);
+}
+
+/* Scores of all the moves of pos for the analysis mode, drawn from
+ * analysis while it runs. Deepens until the end of the game, solving 
+ * it exactly from endgame_empties, or until stop_search is set. The 
+ * result has the best move */
+reversi::SearchResult MainWindow::computer_analysis(const Position& pos)
+{
+    reversi::SearchLimits limits;
+    limits.endgame_empties = endgame_empties;
+    limits.stop = &stop_search;
+    limits.progress = &progress;
+    
+    const reversi::AnalysisResult a = computer.analyze(pos, limits, &analysis);
+    
+    reversi::SearchResult res;
+    res.depth = a.depth;
+    res.nodes = a.nodes;
+    res.evals = a.evals;
+    res.time_ms = a.time_ms;
+    if (!a.moves.empty()) {
+        res.move = a.moves[0].move;
+        res.score = a.moves[0].score;
+        res.exact = a.moves[0].exact;
+        res.pv = a.moves[0].pv;
+    }
+    return res;
+}
+
+/* Best move for the side to move within limits. Depths count the
+ * move itself as the first ply. Runs on the worker thread: New Game 
+ * and level changes stop it through stop_search */
+reversi::SearchResult MainWindow::computer_move_search(const Position& pos, 
+                                                    const reversi::SearchLimits& limits)
+{
+    reversi::SearchLimits lim = limits;
+    lim.stop = &stop_search;
+    lim.progress = &progress;
+    
+    return computer.search(pos, lim);
+}
+
+void MainWindow::hint()
+{
+    if (thinking) {return;}
+    cancel_search(); // the ponder search or the analysis, one search at a time
+    start_search(Task::hint);
+}
+
+void MainWindow::about()
+{
+    QMessageBox::information(this, "About",
+      "Reversi version 0.1\nAuthor: Fernando B. Giannasi\nmar/2018");
+}
\ No newline at end of file
@@ -0,0 +1,199 @@
+#ifndef REVERSI_MAIN_HEADER
+#define REVERSI_MAIN_HEADER
+
+#include <QMainWindow>
+#include <QSignalMapper>
+#include <QString>
+#include <QIcon>
+#include <QPushButton>
+#include <QLabel>
+#include <QFutureWatcher>
+#include <QTimer>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ui_MainWindow.h"
+#include "Board.h"
+#include "Engine.h"
+#include "Position.h"
+
+enum class Level {
+    beginner=0, intermediate, expert, timed, monte_carlo
+};
+
+namespace Ui {
+    class MainWindow; // forward declaration
+}
+
+class MainWindow final : public QMainWindow {
+    Q_OBJECT
+    
+    std::unique_ptr<Ui::MainWindow> ui;
+    static const int SIZE = 8;
+    QSignalMapper* signalMapper;
+    QIcon black, white;
+    
+    /* The game so far, with the moves taken back by undo until another
+     * move is made. Black (Minimizer, the player) moves on even plies,
+     * passes included; W is Maximizer */
+    reversi::Board board;
+    std::vector<std::vector<QPushButton*>> btn_storage;
+    
+    Level level = Level::intermediate;
+    int time_per_move = 1000; // milliseconds, for Level::timed and Level::monte_carlo
+    
+    int my_score = 0, computer_score = 0;
+    QLabel lab {QString("")};
+    
+    std::random_device seeder {};
+    std::mt19937 engine;
+    
+    reversi::Engine computer;
+    int endgame_empties = reversi::DEFAULT_ENDGAME_EMPTIES; // expert and timed levels
+    
+    // Background search of the computer move or of a hint
+    enum class Task {computer_move, hint};
+    QFutureWatcher<reversi::SearchResult> watcher;
+    std::atomic<bool> stop_search {false};
+    Task task = Task::computer_move;
+    bool thinking = false;
+    
+    /* Pondering: while the player thinks, the computer searches the
+     * position after the reply its last search expects, as it would
+     * after the click. If the player makes that move the result is
+     * played at once, or when the search ends; otherwise it is stopped */
+    enum class Ponder {off, running, done};
+    Ponder ponder = Ponder::off;
+    bool pondering_enabled = true;
+    reversi::Position ponder_pos;          // seen from the computer
+    reversi::SearchResult ponder_result;
+    reversi::SearchResult last_move;       // its line holds the expected reply
+    bool ponder_hit = false;
+    std::chrono::steady_clock::time_point reply_start;
+    
+    /* Analysis mode: on the player's turn every legal move is scored, 
+     * deeper and deeper, and the scores are drawn on the buttons as 
+     * they come. It takes the place of pondering */
+    bool analysis_enabled = false;
+    bool analyzing = false;
+    reversi::AnalysisProgress analysis;
+    
+    // Live figures of the running search, shown in the status bar every few tenths of a second
+    reversi::SearchProgress progress;
+    QTimer progress_timer;
+    
+    // JSON lines, one per search, when a log was asked for
+    std::ofstream search_log;
+
+public:
+    MainWindow(QMainWindow* parent = nullptr);
+    
+    MainWindow(const MainWindow&) = delete;
+    MainWindow& operator=(const MainWindow&) = delete;
+    MainWindow(MainWindow&&) = delete;
+    MainWindow& operator=(MainWindow&&) = delete;
+    ~MainWindow();
+    
+    // Memory given to the transposition table of the computer player
+    void set_hash_size(const std::size_t size_mb);
+    
+    // Threads used by the computer player and how they share the work
+    void set_threads(const int num_threads, const reversi::ParallelMode mode);
+    
+    // Evaluation by pattern tables instead of the heuristic function
+    void set_pattern_evaluation(const bool enable);
+    
+    // Pattern weights trained by tools/train, used from then on. Returns false if they can't be loaded
+    bool set_pattern_weights(const std::string& path);
+    
+    // Opening book file built by tools/book. Returns false if it can't be opened
+    bool set_opening_book(const std::string& path);
+    
+    // Selective search with the parameters of tools/probcut. Returns false if they can't be loaded
+    bool set_probcut(const std::string& path);
+    
+    // Empty squares from which the expert levels solve the game exactly, 0 never
+    void set_endgame_empties(const int empties);
+    
+    // Appends the report of each search as a line of JSON to path. Returns false if it can't be opened
+    bool set_search_log(const std::string& path);
+    
+    // Search on the player's time, on by default
+    void set_pondering(const bool enable);
+    
+private slots:
+    void buttonClicked(QString);
+    void search_finished();
+    void show_progress();
+    void newGame();
+    void set_beginner_level();
+    void set_intermediate_level();
+    void set_expert_level();
+    void set_timed_level();
+    void set_monte_carlo_level();
+    void hint();
+    void about();
+    void undo();
+    void redo();
+    void toggle_pondering(bool enable);
+    void toggle_analysis(bool enable);
+    
+private:
+    reversi::Position position(const bool isMax) const noexcept;
+    bool white_to_move() const noexcept {return board.plies() % 2 == 1;}
+    
+    bool is_valid_move(const int row,
+                       const int col,
+                       const bool isMax) const noexcept;
+    
+    void update_icons();
+    
+    void make_move(const int row,
+                   const int col,
+                   const bool isMax);
+    
+    bool has_moves_available(const bool isMax) const noexcept;
+    
+    void block_all_cells();
+    void resume_game();
+    void update_scores() noexcept;
+    void update_status_bar();
+    bool check_end() const noexcept;
+    void show_result();
+    void show_search_stats(const reversi::SearchResult& res, const QString& prefix = QString());
+    void log_search(const reversi::SearchReport& report);
+    
+    void start_search(const Task t);
+    void cancel_search();
+    void play_result(const reversi::SearchResult& res);
+    
+    void start_ponder(const reversi::SearchResult& res);
+    void take_ponder();
+    void stop_ponder();
+    void player_turn(const reversi::SearchResult& last);
+    
+    void start_analysis();
+    void stop_analysis();
+    void show_analysis();
+    void clear_analysis();
+    
+    // Run on the worker thread, so they get the position instead of reading the board
+    reversi::SearchResult computer_move(const reversi::Position& pos);
+    reversi::SearchResult computer_move_beginner(const reversi::Position& pos);
+    reversi::SearchResult computer_move_intermediate(const reversi::Position& pos);
+    reversi::SearchResult computer_move_expert(const reversi::Position& pos);
+    reversi::SearchResult computer_move_timed(const reversi::Position& pos);
+    reversi::SearchResult computer_move_monte_carlo(const reversi::Position& pos);
+    reversi::SearchResult computer_move_search(const reversi::Position& pos, const reversi::SearchLimits& limits);
+    reversi::SearchResult computer_analysis(const reversi::Position& pos);
+
+}; // class MainWindow
+
+
+#endif // REVERSI_MAIN_HEADER
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QMessageBox>
+#include <algorithm>
+#include <thread>
+#include "MainWindow.h"
+
+int main(int argc, char* argv[])
+{
+    QApplication app (argc, argv);
+    
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption hash_option ("hash", "Transposition table size in MB.", "MB",
+                                    QString::number(reversi::TranspositionTable::DEFAULT_SIZE_MB));
+    parser.addOption(hash_option);
+    QCommandLineOption threads_option ("threads", "Search threads (default: all cores).", "N",
+                                       QString::number(std::max(1u, std::thread::hardware_concurrency())));
+    parser.addOption(threads_option);
+    QCommandLineOption smp_option ("smp", "How threads share the search: lazy or root.", "mode", "lazy");
+    parser.addOption(smp_option);
+    QCommandLineOption endgame_option ("endgame", "Solve exactly from this many empty squares, 0 never.", "N",
+                                       QString::number(reversi::DEFAULT_ENDGAME_EMPTIES));
+    parser.addOption(endgame_option);
+    QCommandLineOption eval_option ("eval", "Evaluation: heuristic or patterns.", "type", "heuristic");
+    parser.addOption(eval_option);
+    QCommandLineOption weights_option ("weights", "Pattern weights trained by tools/train.", "file");
+    parser.addOption(weights_option);
+    QCommandLineOption book_option ("book", "Opening book built by tools/book.", "file");
+    parser.addOption(book_option);
+    QCommandLineOption probcut_option ("probcut", "Multi-ProbCut parameters calibrated by tools/probcut.", "file");
+    parser.addOption(probcut_option);
+    QCommandLineOption log_option ("log", "Append a JSON report of each search to this file.", "file");
+    parser.addOption(log_option);
+    QCommandLineOption no_ponder_option ("no-ponder", "Do not search while it is your turn.");
+    parser.addOption(no_ponder_option);
+    parser.process(app);
+    
+    const reversi::ParallelMode mode = parser.value(smp_option) == "root" ? reversi::ParallelMode::root
+                                                                          : reversi::ParallelMode::lazy_smp;
+    
+    MainWindow win;
+    win.set_hash_size(parser.value(hash_option).toUInt());
+    win.set_threads(parser.value(threads_option).toInt(), mode);
+    win.set_endgame_empties(parser.value(endgame_option).toInt());
+    if (parser.isSet(weights_option)) {
+        // Trained weights mean pattern evaluation unless asked otherwise
+        if (!win.set_pattern_weights(parser.value(weights_option).toStdString())) {
+            QMessageBox::warning(&win, "Pattern weights", "Could not load " + parser.value(weights_option));
+        }
+        if (parser.isSet(eval_option)) {win.set_pattern_evaluation(parser.value(eval_option) == "patterns");}
+    }
+    else {
+        win.set_pattern_evaluation(parser.value(eval_option) == "patterns");
+    }
+    if (parser.isSet(book_option) && !win.set_opening_book(parser.value(book_option).toStdString())) {
+        QMessageBox::warning(&win, "Opening book", "Could not open " + parser.value(book_option));
+    }
+    if (parser.isSet(probcut_option) && !win.set_probcut(parser.value(probcut_option).toStdString())) {
+        QMessageBox::warning(&win, "ProbCut", "Could not load " + parser.value(probcut_option));
+    }
+    if (parser.isSet(log_option) && !win.set_search_log(parser.value(log_option).toStdString())) {
+        QMessageBox::warning(&win, "Search log", "Could not open " + parser.value(log_option));
+    }
+    if (parser.isSet(no_ponder_option)) {win.set_pondering(false);}
+    win.show();
+    
+    return app.exec();
+}
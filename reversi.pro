@@ -1,18 +1,26 @@
-TEMPLATE = app
-TARGET = reversi
-INCLUDEPATH += .
-DEFINES += QT_DEPRECATED_WARNINGS
+# The engine is a Qt-free static library; the game and the tools link it
+TEMPLATE = subdirs
 
-# Input
-HEADERS += MainWindow.h
-FORMS += MainWindow.ui
-SOURCES += MainWindow.cpp reversi.cpp
+SUBDIRS += engine gui bench book perft selfplay train tournament probcut analyze server loadgen
+bench.subdir = tools/bench
+book.subdir = tools/book
+perft.subdir = tools/perft
+selfplay.subdir = tools/selfplay
+train.subdir = tools/train
+tournament.subdir = tools/tournament
+probcut.subdir = tools/probcut
+analyze.subdir = tools/analyze
+server.subdir = tools/server
+loadgen.subdir = tools/loadgen
 
-# Custom config
-QT += widgets
-QMAKE_CXXFLAGS += -std=c++14
-CONFIG += release
-#CONFIG += debug
-QMAKE_POST_LINK=$(STRIP) $(TARGET)
-target.path = /usr/local/bin/
-INSTALLS += target
+gui.depends = engine
+bench.depends = engine
+book.depends = engine
+perft.depends = engine
+selfplay.depends = engine
+train.depends = engine
+tournament.depends = engine
+probcut.depends = engine
+analyze.depends = engine
+server.depends = engine
+loadgen.depends = engine
@@ -0,0 +1,228 @@
+/* Batch analysis: reads positions from stdin, one per line as 64
+ * characters in square order and the side to move (see parse_board),
+ * searches them on a pool of threads to a fixed depth or for a fixed
+ * time each and writes one line per position as soon as it is done:
+ *
+ *     line move score depth nodes
+ *
+ * line is the number of the input line, since results come out in the
+ * order they complete; move is "pass" when the side to move must pass
+ * and "--" when the game is over, and the score is the final disc
+ * difference when the position was solved (the depth is then its
+ * number of empties). Empty lines and lines starting with '#' are
+ * skipped, invalid ones reported on stderr. Memory does not grow with
+ * the input: at most a few lines per thread are read ahead, and each
+ * thread has its own table, cleared before each position so that the
+ * results do not depend on the order or the number of threads.
+ *
+ * usage: analyze [-d depth | -l time_ms] [-e endgame_empties] [-t threads] [-m hash_mb]
+ *                [-w weights] [-p probcut_file] < positions > results
+ * hash_mb is per thread */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Endgame.h"
+#include "GameRecord.h"
+#include "Patterns.h"
+#include "ProbCut.h"
+#include "Search.h"
+
+using namespace reversi;
+
+namespace {
+
+// Longest line read, the board and side to move leave room for a comment
+constexpr int MAX_LINE = 256;
+
+// Lines read ahead per thread
+constexpr std::size_t QUEUE_PER_THREAD = 4;
+
+struct Job {
+    unsigned long long line = 0;
+    Position pos;
+};
+
+/* Positions read but not yet taken by a worker, at most capacity of
+ * them: the reader waits while it is full, workers while it is empty */
+class JobQueue {
+public:
+    explicit JobQueue(const std::size_t cap) : capacity{cap} {}
+    
+    void push(const Job& job)
+    {
+        std::unique_lock<std::mutex> lock (mutex);
+        not_full.wait(lock, [this]() {return jobs.size() < capacity;});
+        jobs.push_back(job);
+        not_empty.notify_one();
+    }
+    
+    // False once the input has ended and every job was taken
+    bool pop(Job& job)
+    {
+        std::unique_lock<std::mutex> lock (mutex);
+        not_empty.wait(lock, [this]() {return !jobs.empty() || closed;});
+        if (jobs.empty()) {return false;}
+        
+        job = jobs.front();
+        jobs.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+    
+    void close()
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        closed = true;
+        not_empty.notify_all();
+    }
+    
+private:
+    std::mutex mutex;
+    std::condition_variable not_full, not_empty;
+    std::deque<Job> jobs;
+    const std::size_t capacity;
+    bool closed = false;
+};
+
+/* Reads one line into buf, false at the end of the input. A line too
+ * long for buf is skipped to its end and returned as too_long */
+bool read_line(char* buf, const int size, bool& too_long)
+{
+    if (!std::fgets(buf, size, stdin)) {return false;}
+    
+    const std::size_t len = std::strlen(buf);
+    too_long = len + 1 == static_cast<std::size_t>(size) && buf[len-1] != '\n';
+    if (too_long) {
+        int c;
+        do {c = std::getchar();} while (c != '\n' && c != EOF);
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int depth = 0, time_ms = 0;
+    int endgame_empties = 0;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    int hash_mb = 4;
+    std::string weights, probcut_file;
+    bool ok = true;
+    
+    for (int i=1; i<argc; ++i) {
+        if (!std::strcmp(argv[i], "-d") && i+1 < argc) {depth = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-l") && i+1 < argc) {time_ms = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-e") && i+1 < argc) {endgame_empties = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-t") && i+1 < argc) {threads = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-m") && i+1 < argc) {hash_mb = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-w") && i+1 < argc) {weights = argv[++i];}
+        else if (!std::strcmp(argv[i], "-p") && i+1 < argc) {probcut_file = argv[++i];}
+        else {ok = false; break;}
+    }
+    if (depth == 0 && time_ms == 0) {depth = 8;}
+    
+    if (!ok || (depth > 0 && time_ms > 0) || depth < 0 || depth > MAX_DEPTH || time_ms < 0 ||
+        endgame_empties < 0 || threads < 1 || hash_mb < 1) {
+        std::fprintf(stderr, "usage: %s [-d depth | -l time_ms] [-e endgame_empties] [-t threads] [-m hash_mb]\n"
+                             "       [-w weights] [-p probcut_file] < positions > results\n", argv[0]);
+        return 1;
+    }
+    
+    PatternEvaluator patterns;
+    if (!weights.empty() && !patterns.load(weights)) {
+        std::fprintf(stderr, "cannot load weights %s\n", weights.c_str());
+        return 1;
+    }
+    ProbCut probcut;
+    if (!probcut_file.empty() && !probcut.load(probcut_file)) {
+        std::fprintf(stderr, "cannot load %s\n", probcut_file.c_str());
+        return 1;
+    }
+    
+    SearchLimits limits;
+    if (depth > 0) {limits.depth = depth;}
+    limits.time_ms = time_ms;
+    limits.endgame_empties = endgame_empties;
+    if (!weights.empty()) {limits.patterns = &patterns;}
+    if (!probcut_file.empty()) {limits.probcut = &probcut;}
+    
+    JobQueue queue (QUEUE_PER_THREAD * threads);
+    std::mutex output;
+    std::atomic<unsigned long long> positions {0}, total_nodes {0};
+    const auto start = std::chrono::steady_clock::now();
+    
+    auto worker = [&]() {
+        TranspositionTable tt (hash_mb);
+        Search search (&tt);
+        Job job;
+        
+        while (queue.pop(job)) {
+            SearchResult res;
+            if (job.pos.has_moves() || job.pos.pass().has_moves()) {
+                tt.clear();
+                res = search.run(job.pos, limits);
+            }
+            else {
+                res.score = final_score(job.pos);
+                res.exact = true;
+            }
+            
+            std::string move = "--";
+            if (res.move >= 0) {move = square_name(res.move);}
+            else if (!res.exact) {move = "pass";}
+            const int d = res.exact ? job.pos.num_empties() : res.depth;
+            
+            {
+                std::lock_guard<std::mutex> lock (output);
+                std::printf("%llu %s %d %d %llu\n", job.line, move.c_str(), res.score, d,
+                            static_cast<unsigned long long>(res.nodes));
+                std::fflush(stdout);
+            }
+            ++positions;
+            total_nodes += res.nodes;
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (int t=0; t<threads; ++t) {pool.emplace_back(worker);}
+    
+    char buf[MAX_LINE];
+    unsigned long long line = 0, invalid = 0;
+    bool too_long = false;
+    
+    while (read_line(buf, MAX_LINE, too_long)) {
+        ++line;
+        if (buf[0] == '\n' || buf[0] == '\r' || buf[0] == '\0' || buf[0] == '#') {continue;}
+        
+        Job job;
+        job.line = line;
+        bool white_to_move;
+        if (too_long || !parse_board(buf, job.pos, white_to_move)) {
+            std::fprintf(stderr, "line %llu: not a position\n", line);
+            ++invalid;
+            continue;
+        }
+        queue.push(job);
+    }
+    
+    queue.close();
+    for (auto& th: pool) {th.join();}
+    
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr, "%llu positions, %llu invalid, %llu nodes in %.1f s: %.1f positions/s, %.0f knodes/s\n",
+                 positions.load(), invalid, total_nodes.load(), seconds,
+                 seconds > 0 ? positions / seconds : 0.0, seconds > 0 ? total_nodes / seconds / 1000 : 0.0);
+    return 0;
+}
@@ -0,0 +1,215 @@
+/* Search benchmark: time to a fixed depth on a fixed set of midgame 
+ * positions, with 1, 2, 4 ... N threads in each parallel mode. Prints 
+ * nodes per second, the speedup over a single thread and the heap
+ * allocations per search, counted by replacing operator new. A single
+ * thread search allocates once, for the principal variation it returns,
+ * however many nodes it visits; threaded searches add their threads.
+ * For the single thread runs it also prints how often the first move
+ * searched gave the cutoff at each ply, which measures move ordering.
+ * The evaluation is the heuristic one or the initial pattern tables.
+ * With -c it also runs the Monte Carlo search for that many milliseconds
+ * per position on 1, 2, 4 ... N threads and prints its playouts per
+ * second per core, the figure its tuning aims at.
+ *
+ * usage: bench [-d depth] [-t max_threads] [-m hash_mb] [-n positions] [-e heuristic|patterns]
+ *              [-c monte_carlo_ms] */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MonteCarlo.h"
+#include "ParallelSearch.h"
+#include "Patterns.h"
+
+using namespace reversi;
+
+namespace {
+
+std::atomic<std::uint64_t> allocations {0};
+
+} // namespace
+
+// Every allocation of the program goes through here, new[] included
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {return p;}
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+// Positions after random openings. The seed is fixed so every run benchmarks the same set
+std::vector<Position> make_positions(const int count)
+{
+    std::mt19937 rng (2018);
+    std::vector<Position> res;
+    
+    while (static_cast<int>(res.size()) < count) {
+        Position pos = Position::initial();
+        const int plies = 16 + rng() % 12;
+        
+        for (int i=0; i<plies && pos.has_moves(); ++i) {
+            Bitboard moves = pos.moves();
+            for (int n = rng() % popcount(moves); n > 0; --n) {
+                moves &= moves - 1;
+            }
+            pos = pos.play(first_square(moves));
+            if (!pos.has_moves()) {pos = pos.pass();}
+        }
+        
+        if (pos.has_moves()) {res.push_back(pos);}
+    }
+    return res;
+}
+
+struct Run {
+    double seconds = 0;
+    std::uint64_t nodes = 0;
+    std::uint64_t allocations = 0;
+    CutoffStats cutoffs;
+};
+
+Run run(const std::vector<Position>& positions, 
+        TranspositionTable& tt,
+        const int depth, 
+        const int threads, 
+        const ParallelMode mode,
+        const PatternEvaluator* patterns)
+{
+    Run r;
+    SearchLimits limits;
+    limits.depth = depth;
+    limits.patterns = patterns;
+    
+    for (const auto& pos: positions) {
+        tt.clear();
+        ParallelSearch search (&tt, threads, mode);
+        
+        const std::uint64_t allocated = allocations.load();
+        const auto start = std::chrono::steady_clock::now();
+        const SearchResult res = search.run(pos, limits);
+        r.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        r.allocations += allocations.load() - allocated;
+        r.nodes += res.nodes;
+        r.cutoffs += res.cutoffs;
+    }
+    return r;
+}
+
+// Thread counts of the sweeps double, and the last is max_threads whatever it is
+int next_threads(const int threads, const int max_threads) noexcept
+{
+    return threads < max_threads && threads * 2 > max_threads ? max_threads : threads * 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int depth = 10;
+    int max_threads = std::max(1u, std::thread::hardware_concurrency());
+    int hash_mb = 64;
+    int count = 12;
+    std::string eval = "heuristic";
+    int monte_carlo_ms = 0;
+    bool ok = true;
+    
+    for (int i=1; i<argc; ++i) {
+        if (!std::strcmp(argv[i], "-d") && i+1 < argc) {depth = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-t") && i+1 < argc) {max_threads = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-m") && i+1 < argc) {hash_mb = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-n") && i+1 < argc) {count = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-e") && i+1 < argc) {eval = argv[++i];}
+        else if (!std::strcmp(argv[i], "-c") && i+1 < argc) {monte_carlo_ms = std::atoi(argv[++i]);}
+        else {ok = false; break;}
+    }
+    
+    if (!ok || (eval != "heuristic" && eval != "patterns") || depth < 1 || depth > MAX_DEPTH ||
+        max_threads < 1 || hash_mb < 1 || count < 1 || monte_carlo_ms < 0) {
+        std::fprintf(stderr, "usage: %s [-d depth] [-t max_threads] [-m hash_mb] [-n positions]\n"
+                             "       [-e heuristic|patterns] [-c monte_carlo_ms]\n", argv[0]);
+        return 1;
+    }
+    
+    PatternEvaluator tables;
+    const PatternEvaluator* patterns = eval == "patterns" ? &tables : nullptr;
+    
+    const std::vector<Position> positions = make_positions(count);
+    TranspositionTable tt (hash_mb);
+    
+    std::printf("%d positions, depth %d, %d MB hash, %s evaluation\n\n", count, depth, hash_mb, eval.c_str());
+    std::printf("%-9s %7s %10s %14s %12s %8s %12s\n", "mode", "threads", "time (s)", "nodes", "knps", "speedup",
+                "allocs/srch");
+    
+    const Run base = run(positions, tt, depth, 1, ParallelMode::none, patterns);
+    std::printf("%-9s %7d %10.3f %14llu %12.0f %8.2f %12.1f\n", "single", 1, base.seconds,
+                static_cast<unsigned long long>(base.nodes), base.nodes / base.seconds / 1000, 1.0,
+                static_cast<double>(base.allocations) / count);
+    
+    const ParallelMode modes[] = {ParallelMode::root, ParallelMode::lazy_smp};
+    const char* names[] = {"root", "lazy-smp"};
+    
+    for (int m=0; m<2; ++m) {
+        for (int t=2; t<=max_threads; t=next_threads(t, max_threads)) {
+            const Run r = run(positions, tt, depth, t, modes[m], patterns);
+            std::printf("%-9s %7d %10.3f %14llu %12.0f %8.2f %12.1f\n", names[m], t, r.seconds,
+                        static_cast<unsigned long long>(r.nodes), r.nodes / r.seconds / 1000,
+                        base.seconds / r.seconds, static_cast<double>(r.allocations) / count);
+        }
+    }
+    
+    std::printf("\n%4s %14s %12s\n", "ply", "cutoffs", "first move");
+    for (int ply=0; ply<=MAX_DEPTH; ++ply) {
+        const std::uint64_t n = base.cutoffs.cutoffs[ply];
+        if (n == 0) {continue;}
+        std::printf("%4d %14llu %11.1f%%\n", ply, static_cast<unsigned long long>(n),
+                    100.0 * base.cutoffs.first_move[ply] / n);
+    }
+    
+    if (monte_carlo_ms > 0) {
+        MonteCarloSearch mcts;
+        SearchLimits limits;
+        limits.time_ms = monte_carlo_ms;
+        
+        std::printf("\nMonte Carlo, %d ms per position\n", monte_carlo_ms);
+        std::printf("%7s %14s %14s %14s %8s\n", "threads", "playouts", "playouts/s", "per core", "speedup");
+        
+        double base_rate = 0;
+        for (int t=1; t<=max_threads; t=next_threads(t, max_threads)) {
+            std::uint64_t playouts = 0;
+            double seconds = 0;
+            for (const auto& pos: positions) {
+                mcts.clear();
+                mcts.run(pos, limits, t);
+                playouts += mcts.stats().playouts;
+                seconds += mcts.stats().seconds;
+            }
+            
+            const double rate = playouts / seconds;
+            if (t == 1) {base_rate = rate;}
+            std::printf("%7d %14llu %14.0f %14.0f %8.2f\n", t, static_cast<unsigned long long>(playouts),
+                        rate, rate / t, rate / base_rate);
+        }
+    }
+    
+    return 0;
+}
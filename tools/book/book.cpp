@@ -0,0 +1,166 @@
+/* Builds an opening book from game records: one finished game per line, 
+ * as a transcript like "f5d6c3d3c4f4...". For every position of the first
+ * plies it keeps the move with the best mean result among the moves 
+ * played there at least min_games times. Positions are merged under the
+ * 8 symmetries of the board.
+ *
+ * usage: book [-p plies] [-n min_games] -o book_file [record_file...]
+ * Records are read from stdin when no file is given */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Endgame.h"
+#include "GameRecord.h"
+#include "OpeningBook.h"
+
+using namespace reversi;
+
+namespace {
+
+struct MoveStats {
+    std::uint32_t games = 0;
+    std::int64_t score = 0; // sum of the final disc differences for the mover
+};
+
+struct PositionHash {
+    std::size_t operator()(const Position& pos) const noexcept {return pos.hash();}
+};
+
+// Results of each move played in each canonical position
+using Tally = std::unordered_map<Position, std::unordered_map<int, MoveStats>, PositionHash>;
+
+struct Counts {
+    std::uint64_t games = 0;
+    std::uint64_t rejected = 0;
+};
+
+void add_game(const GameRecord& game, const int plies, Tally& tally)
+{
+    // Final disc difference for Black
+    bool white_to_move;
+    const int result = final_score(game.final_position(&white_to_move));
+    const int black_result = white_to_move ? -result : result;
+    
+    Position pos = Position::initial();
+    bool white = false;
+    
+    for (int i=0; i<plies && i<static_cast<int>(game.moves.size()); ++i) {
+        const int sq = game.moves[i];
+        if (!pos.is_legal(sq)) {
+            pos = pos.pass();
+            white = !white;
+        }
+        
+        int sym;
+        const Position key = pos.canonical(&sym);
+        MoveStats& st = tally[key][transform_square(sq, sym)];
+        ++st.games;
+        st.score += white ? -black_result : black_result;
+        
+        pos = pos.play(sq);
+        white = !white;
+    }
+}
+
+void read_records(std::istream& in, const int plies, Tally& tally, Counts& counts)
+{
+    std::string line;
+    GameRecord game;
+    
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {continue;}
+        
+        if (!parse_game(line, game) || !game.is_finished()) {
+            ++counts.rejected;
+            continue;
+        }
+        add_game(game, plies, tally);
+        ++counts.games;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int plies = 20;
+    int min_games = 3;
+    std::string output;
+    std::vector<std::string> inputs;
+    
+    for (int i=1; i<argc; ++i) {
+        if (!std::strcmp(argv[i], "-p") && i+1 < argc) {plies = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-n") && i+1 < argc) {min_games = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-o") && i+1 < argc) {output = argv[++i];}
+        else if (argv[i][0] == '-') {output.clear(); break;}
+        else {inputs.push_back(argv[i]);}
+    }
+    
+    if (output.empty()) {
+        std::fprintf(stderr, "usage: %s [-p plies] [-n min_games] -o book_file [record_file...]\n", argv[0]);
+        return 1;
+    }
+    
+    Tally tally;
+    Counts counts;
+    
+    if (inputs.empty()) {read_records(std::cin, plies, tally, counts);}
+    
+    for (const auto& name: inputs) {
+        std::ifstream in (name);
+        if (!in) {
+            std::fprintf(stderr, "cannot read %s\n", name.c_str());
+            return 1;
+        }
+        read_records(in, plies, tally, counts);
+    }
+    
+    std::vector<BookEntry> entries;
+    
+    for (const auto& node: tally) {
+        int best_move = -1;
+        double best_mean = 0;
+        std::uint32_t best_games = 0;
+        
+        for (const auto& mv: node.second) {
+            const MoveStats& st = mv.second;
+            if (st.games < static_cast<std::uint32_t>(min_games)) {continue;}
+            
+            const double mean = static_cast<double>(st.score) / st.games;
+            if (best_move < 0 || mean > best_mean || (mean == best_mean && st.games > best_games)) {
+                best_move = mv.first;
+                best_mean = mean;
+                best_games = st.games;
+            }
+        }
+        
+        if (best_move < 0) {continue;}
+        
+        BookEntry e {};
+        e.player = node.first.player;
+        e.opponent = node.first.opponent;
+        e.games = best_games;
+        e.score = static_cast<std::int16_t>(std::lround(best_mean));
+        e.move = static_cast<std::uint8_t>(best_move);
+        entries.push_back(e);
+    }
+    
+    if (!OpeningBook::write(output, entries)) {
+        std::fprintf(stderr, "cannot write %s\n", output.c_str());
+        return 1;
+    }
+    
+    std::printf("%llu games read, %llu rejected, %zu positions written to %s\n",
+                static_cast<unsigned long long>(counts.games),
+                static_cast<unsigned long long>(counts.rejected),
+                entries.size(), output.c_str());
+    return 0;
+}
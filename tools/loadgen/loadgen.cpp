@@ -0,0 +1,215 @@
+/* Load generator for the engine server: runs a GameServer in process
+ * and plays the given number of games on it at once, speaking its line
+ * protocol. The clients play Black with random moves and ask the engine
+ * to play White with "go". Prints the searches per second, the latency
+ * of "go" (waiting for a worker included) and how the games used their
+ * clocks, then the server's own statistics. Exits with 1 if a game
+ * went over its clock.
+ *
+ * usage: loadgen [-g games] [-c clock_ms] [-t threads] [-m hash_mb] [-e endgame_empties] [-s seed] */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GameRecord.h"
+#include "GameServer.h"
+
+using namespace reversi;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Replies of the server with the time they were given
+class ReplyQueue {
+public:
+    struct Reply {
+        std::string line;
+        Clock::time_point time;
+    };
+    
+    void push(const std::string& line)
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        replies.push_back(Reply{line, Clock::now()});
+        ready.notify_one();
+    }
+    
+    Reply pop()
+    {
+        std::unique_lock<std::mutex> lock (mutex);
+        ready.wait(lock, [this]() {return !replies.empty();});
+        Reply r = replies.front();
+        replies.pop_front();
+        return r;
+    }
+    
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<Reply> replies;
+};
+
+// The game as the client sees it
+struct Client {
+    Position pos = Position::initial();  // Black to move when the engine is not
+    Clock::time_point go_sent;
+    int clock_ms = 0;                    // left, as the server reported it
+    bool finished = false;
+};
+
+bool game_over(const Position& pos) noexcept
+{
+    return !pos.has_moves() && !pos.pass().has_moves();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int games = 1000;
+    int clock_ms = 2000;
+    unsigned seed = 2018;
+    ServerOptions opts;
+    opts.threads = std::max(1u, std::thread::hardware_concurrency());
+    int hash_mb = 64;
+    bool ok = true;
+    
+    for (int i=1; i<argc; ++i) {
+        if (!std::strcmp(argv[i], "-g") && i+1 < argc) {games = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-c") && i+1 < argc) {clock_ms = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-t") && i+1 < argc) {opts.threads = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-m") && i+1 < argc) {hash_mb = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-e") && i+1 < argc) {opts.endgame_empties = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-s") && i+1 < argc) {seed = std::atoi(argv[++i]);}
+        else {ok = false; break;}
+    }
+    
+    if (!ok || games < 1 || clock_ms < 0 || opts.threads < 1 || hash_mb < 1 || opts.endgame_empties < 0) {
+        std::fprintf(stderr, "usage: %s [-g games] [-c clock_ms] [-t threads] [-m hash_mb] [-e endgame_empties] [-s seed]\n",
+                     argv[0]);
+        return 1;
+    }
+    opts.hash_mb = hash_mb;
+    opts.clock_ms = clock_ms;
+    
+    ReplyQueue replies;
+    GameServer server (opts, [&replies](const std::string& line) {replies.push(line);});
+    
+    std::mt19937 rng (seed);
+    std::vector<Client> clients (games);
+    for (Client& c: clients) {c.clock_ms = clock_ms;}
+    std::vector<double> latencies;
+    int finished = 0, errors = 0;
+    
+    auto id_of = [](const int g) {return "g" + std::to_string(g);};
+    
+    // Black's random move, then White's turn unless the game is over
+    auto client_turn = [&](const int g) {
+        Client& c = clients[g];
+        if (game_over(c.pos)) {return;} // the server reports it
+        
+        if (c.pos.has_moves()) {
+            Bitboard moves = c.pos.moves();
+            for (int n = rng() % popcount(moves); n > 0; --n) {moves &= moves - 1;}
+            const int sq = first_square(moves);
+            c.pos = c.pos.play(sq);
+            server.handle("play " + id_of(g) + " " + square_name(sq));
+        }
+        else {
+            c.pos = c.pos.pass();
+            server.handle("play " + id_of(g) + " pass");
+        }
+        
+        if (game_over(c.pos)) {return;}
+        c.go_sent = Clock::now();
+        server.handle("go " + id_of(g));
+    };
+    
+    const Clock::time_point start = Clock::now();
+    for (int g=0; g<games; ++g) {
+        server.handle("new " + id_of(g));
+        client_turn(g);
+    }
+    
+    while (finished < games) {
+        const ReplyQueue::Reply r = replies.pop();
+        std::istringstream fields (r.line);
+        std::string kind, id;
+        fields >> kind >> id;
+        if (kind == "ok") {continue;}
+        
+        const int g = id.size() > 1 ? std::atoi(id.c_str() + 1) : -1;
+        if (g < 0 || g >= games || clients[g].finished) {continue;}
+        Client& c = clients[g];
+        
+        if (kind == "move") {
+            std::string move;
+            int score, depth, ms;
+            unsigned long long nodes;
+            fields >> move >> score >> depth >> nodes >> ms >> c.clock_ms;
+            
+            latencies.push_back(std::chrono::duration<double, std::milli>(r.time - c.go_sent).count());
+            c.pos = move == "pass" ? c.pos.pass() : c.pos.play(parse_square(move.c_str()));
+            client_turn(g);
+        }
+        else if (kind == "over") {
+            c.finished = true;
+            ++finished;
+            server.handle("end " + id);
+        }
+        else {
+            if (++errors <= 10) {std::fprintf(stderr, "%s\n", r.line.c_str());}
+            c.finished = true;
+            ++finished;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    
+    server.wait();
+    server.handle("stats");
+    
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](const double p) {
+        return latencies.empty() ? 0.0 : latencies[std::min(latencies.size() - 1,
+                                                            static_cast<std::size_t>(p * latencies.size()))];
+    };
+    
+    int out_of_time = 0, most_used = 0;
+    for (const Client& c: clients) {
+        most_used = std::max(most_used, clock_ms - c.clock_ms);
+        if (c.clock_ms < 0) {++out_of_time;}
+    }
+    
+    std::printf("%d games at once on %d threads, %d errors, %.1f s\n", games, opts.threads, errors, seconds);
+    std::printf("%zu searches, %.1f searches/s\n", latencies.size(), seconds > 0 ? latencies.size() / seconds : 0.0);
+    std::printf("go latency ms: median %.1f, 90%% %.1f, 99%% %.1f, max %.1f\n",
+                percentile(0.5), percentile(0.9), percentile(0.99), percentile(1.0));
+    std::printf("clock %d ms per game: most used %d ms, %d games over it\n", clock_ms, most_used, out_of_time);
+    
+    // The reply to "stats", the last one
+    for (;;) {
+        const ReplyQueue::Reply r = replies.pop();
+        if (r.line.compare(0, 6, "stats ") == 0) {
+            std::printf("server %s\n", r.line.c_str() + 6);
+            break;
+        }
+    }
+    
+    if (out_of_time > 0) {
+        std::fprintf(stderr, "%d games went over their clock\n", out_of_time);
+        return 1;
+    }
+    return 0;
+}
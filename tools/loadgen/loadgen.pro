@@ -0,0 +1,12 @@
+TEMPLATE = app
+TARGET = loadgen
+CONFIG += console release
+CONFIG -= qt app_bundle
+
+SOURCES += loadgen.cpp ../server/GameServer.cpp
+HEADERS += ../server/GameServer.h
+INCLUDEPATH += ../server
+include(../../engine/engine.pri)
+
+QMAKE_CXXFLAGS += -std=c++14 -pthread
+LIBS += -pthread
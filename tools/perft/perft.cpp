@@ -0,0 +1,93 @@
+/* Move generation benchmark and check: counts the leaves of the game
+ * tree to each depth up to N. A pass counts as a ply, and a finished 
+ * game reached before depth N counts as one leaf. From the initial 
+ * position the counts are checked against the known ones.
+ *
+ * usage: perft [-d depth] [board]
+ * board: 64 characters ('X' Black, 'O' White, '-' empty) and the side
+ * to move, as one argument */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "GameRecord.h"
+#include "Position.h"
+
+using namespace reversi;
+
+namespace {
+
+// Leaves from the initial position, index is the depth
+const unsigned long long REFERENCE[] = {
+    1ULL, 4ULL, 12ULL, 56ULL, 244ULL, 1396ULL, 8200ULL, 55092ULL, 390216ULL, 
+    3005288ULL, 24571284ULL, 212258800ULL, 1939886636ULL, 18429641748ULL, 
+    184042084512ULL
+};
+
+const int MAX_REFERENCE = sizeof(REFERENCE) / sizeof(REFERENCE[0]) - 1;
+
+unsigned long long perft(const Position& pos, const int depth, const bool passed)
+{
+    if (depth == 0) {return 1;}
+    
+    const Bitboard moves = pos.moves();
+    if (!moves) {
+        if (passed) {return 1;} // game over
+        return perft(pos.pass(), depth-1, true);
+    }
+    
+    unsigned long long leaves = 0;
+    for (Bitboard mv = moves; mv; mv &= mv - 1) {
+        leaves += perft(pos.play(first_square(mv)), depth-1, false);
+    }
+    return leaves;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int max_depth = 11;
+    Position pos = Position::initial();
+    bool white_to_move = false;
+    bool initial = true;
+    
+    for (int i=1; i<argc; ++i) {
+        if (!std::strcmp(argv[i], "-d") && i+1 < argc) {
+            max_depth = std::atoi(argv[++i]);
+        }
+        else if (parse_board(argv[i], pos, white_to_move)) {
+            initial = pos == Position::initial() && !white_to_move;
+        }
+        else {
+            std::fprintf(stderr, "usage: %s [-d depth] [board]\n", argv[0]);
+            return 1;
+        }
+    }
+    
+    std::printf("%s\n\n", board_string(pos, white_to_move).c_str());
+    std::printf("%5s %16s %10s %12s%s\n", "depth", "leaves", "time (s)", "Mnps", initial ? "  reference" : "");
+    
+    bool ok = true;
+    
+    for (int depth=1; depth<=max_depth; ++depth) {
+        const auto start = std::chrono::steady_clock::now();
+        const unsigned long long leaves = perft(pos, depth, false);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        std::printf("%5d %16llu %10.3f %12.1f", depth, leaves, seconds, leaves / seconds / 1e6);
+        
+        if (initial && depth <= MAX_REFERENCE) {
+            const bool match = leaves == REFERENCE[depth];
+            std::printf("  %s", match ? "ok" : "MISMATCH");
+            ok = ok && match;
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+    
+    return ok ? 0 : 1;
+}
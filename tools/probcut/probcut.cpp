@@ -0,0 +1,245 @@
+/* Calibrates Multi-ProbCut: searches a set of positions to every depth
+ * up to max_depth and fits, for each depth d from 3 on, the linear
+ * relation between its scores and those of shallower depths of the
+ * same parity: about d/4 where there is one, tried first as it is
+ * cheaper, and about d/2. Prints the fits and writes the parameter
+ * file read by --probcut. The evaluation must be the one the engine
+ * will play with.
+ *
+ * usage: probcut [-n positions] [-d max_depth] [-x threshold] [-t threads] [-m hash_mb]
+ *                [-e heuristic|patterns] [-w weights] [-r record_file] -o params_file
+ * Positions come from random games with a fixed seed, or one from each
+ * game of record_file (compact records of tools/selfplay) */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GameRecord.h"
+#include "Patterns.h"
+#include "ProbCut.h"
+#include "Search.h"
+
+using namespace reversi;
+
+namespace {
+
+// Plies from the start of the positions searched, away from the opening and the endgame
+constexpr int MIN_PLY = 8;
+constexpr int MAX_PLY = 48;
+
+// Shallow depths of the checks, as fractions of the depth, the cheaper first
+constexpr int SHALLOW_DIVISORS[MAX_PROBCUT_CHECKS] = {4, 2};
+
+// Depth of the same parity as depth, about depth / divisor, 0 if there is none
+int shallow_depth(const int depth, const int divisor) noexcept
+{
+    int s = depth / divisor;
+    if ((depth - s) % 2) {--s;}
+    return std::max(s, 0);
+}
+
+std::vector<Position> random_positions(const int count)
+{
+    std::mt19937 rng (2018);
+    std::vector<Position> res;
+    
+    while (static_cast<int>(res.size()) < count) {
+        Position pos = Position::initial();
+        const int plies = MIN_PLY + rng() % (MAX_PLY - MIN_PLY + 1);
+        
+        for (int i=0; i<plies && pos.has_moves(); ++i) {
+            Bitboard moves = pos.moves();
+            for (int n = rng() % popcount(moves); n > 0; --n) {moves &= moves - 1;}
+            pos = pos.play(first_square(moves));
+            if (!pos.has_moves()) {pos = pos.pass();}
+        }
+        
+        if (pos.has_moves()) {res.push_back(pos);}
+    }
+    return res;
+}
+
+bool record_positions(const std::string& name, const int count, std::vector<Position>& res)
+{
+    std::FILE* f = std::fopen(name.c_str(), "rb");
+    if (!f) {return false;}
+    
+    std::mt19937 rng (2018);
+    GameRecord game;
+    
+    while (static_cast<int>(res.size()) < count && read_record(f, game)) {
+        const std::vector<Position> positions = game.positions();
+        if (static_cast<int>(positions.size()) <= MIN_PLY) {continue;}
+        
+        const int last = std::min<int>(positions.size() - 1, MAX_PLY);
+        res.push_back(positions[MIN_PLY + rng() % (last - MIN_PLY + 1)]);
+    }
+    std::fclose(f);
+    return true;
+}
+
+// Least squares fit of deep = a * shallow + b
+struct Fit {
+    int samples = 0;
+    double a = 1, b = 0, sigma = 0, r = 0;
+};
+
+Fit fit(const std::vector<double>& x, const std::vector<double>& y)
+{
+    Fit f;
+    f.samples = x.size();
+    if (f.samples < 3) {return f;}
+    
+    const double n = f.samples;
+    double sx = 0, sy = 0, sxx = 0, sxy = 0, syy = 0;
+    for (std::size_t i=0; i<x.size(); ++i) {
+        sx += x[i];
+        sy += y[i];
+        sxx += x[i] * x[i];
+        sxy += x[i] * y[i];
+        syy += y[i] * y[i];
+    }
+    
+    const double vx = sxx - sx * sx / n, vy = syy - sy * sy / n, cxy = sxy - sx * sy / n;
+    if (vx <= 0 || vy <= 0) {return f;}
+    
+    f.a = cxy / vx;
+    f.b = (sy - f.a * sx) / n;
+    f.r = cxy / std::sqrt(vx * vy);
+    
+    double sse = 0;
+    for (std::size_t i=0; i<x.size(); ++i) {
+        const double e = y[i] - (f.a * x[i] + f.b);
+        sse += e * e;
+    }
+    f.sigma = std::sqrt(sse / (n - 2));
+    return f;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int count = 500;
+    int max_depth = 8;
+    double threshold = 1.5;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    int hash_mb = 16;
+    std::string eval = "heuristic", weights, records, output;
+    
+    for (int i=1; i<argc; ++i) {
+        if (!std::strcmp(argv[i], "-n") && i+1 < argc) {count = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-d") && i+1 < argc) {max_depth = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-x") && i+1 < argc) {threshold = std::atof(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-t") && i+1 < argc) {threads = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-m") && i+1 < argc) {hash_mb = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-e") && i+1 < argc) {eval = argv[++i];}
+        else if (!std::strcmp(argv[i], "-w") && i+1 < argc) {weights = argv[++i];}
+        else if (!std::strcmp(argv[i], "-r") && i+1 < argc) {records = argv[++i];}
+        else if (!std::strcmp(argv[i], "-o") && i+1 < argc) {output = argv[++i];}
+        else {output.clear(); break;}
+    }
+    
+    if (output.empty() || count < 3 || max_depth < 3 || max_depth > MAX_DEPTH || threads < 1 ||
+        threshold < 0 || (eval != "heuristic" && eval != "patterns")) {
+        std::fprintf(stderr, "usage: %s [-n positions] [-d max_depth] [-x threshold] [-t threads] [-m hash_mb]\n"
+                             "       [-e heuristic|patterns] [-w weights] [-r record_file] -o params_file\n", argv[0]);
+        return 1;
+    }
+    
+    PatternEvaluator patterns;
+    if (!weights.empty()) {
+        if (!patterns.load(weights)) {
+            std::fprintf(stderr, "cannot load weights %s\n", weights.c_str());
+            return 1;
+        }
+        eval = "patterns";
+    }
+    
+    std::vector<Position> positions;
+    if (records.empty()) {positions = random_positions(count);}
+    else if (!record_positions(records, count, positions)) {
+        std::fprintf(stderr, "cannot read %s\n", records.c_str());
+        return 1;
+    }
+    
+    // scores[i * (max_depth + 1) + d] is the score of position i searched to depth d
+    const int stride = max_depth + 1;
+    std::vector<int> scores (positions.size() * stride, 0);
+    std::atomic<std::size_t> next {0};
+    std::atomic<int> done {0};
+    
+    auto worker = [&]() {
+        TranspositionTable tt (hash_mb);
+        Search search (&tt);
+        SearchLimits limits;
+        if (eval == "patterns") {limits.patterns = &patterns;}
+        
+        for (std::size_t i = next++; i < positions.size(); i = next++) {
+            tt.clear();
+            for (int d=1; d<=max_depth; ++d) {
+                limits.depth = d;
+                scores[i * stride + d] = search.run(positions[i], limits).score;
+            }
+            
+            const int n = ++done;
+            if (n % 50 == 0) {std::fprintf(stderr, "%d positions\n", n);}
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (int t=0; t<threads; ++t) {pool.emplace_back(worker);}
+    for (auto& th: pool) {th.join();}
+    
+    ProbCut probcut;
+    probcut.threshold = threshold;
+    
+    std::printf("%zu positions, %s evaluation\n\n", positions.size(), eval.c_str());
+    std::printf("%5s %7s %8s %10s %10s %10s %7s\n", "depth", "shallow", "samples", "a", "b", "sigma", "r");
+    
+    for (int d=3; d<=max_depth; ++d) {
+        int prev = 0;
+        for (const int divisor: SHALLOW_DIVISORS) {
+            const int s = shallow_depth(d, divisor);
+            if (s < 1 || s == prev) {continue;}
+            prev = s;
+            std::vector<double> x, y;
+            
+            // Finished games score as wins, not as evaluations
+            for (std::size_t i=0; i<positions.size(); ++i) {
+                const int vs = scores[i * stride + s], vd = scores[i * stride + d];
+                if (std::abs(vs) >= SCORE_WIN / 2 || std::abs(vd) >= SCORE_WIN / 2) {continue;}
+                x.push_back(vs);
+                y.push_back(vd);
+            }
+            
+            const Fit f = fit(x, y);
+            std::printf("%5d %7d %8d %10.4f %10.2f %10.2f %7.3f\n", d, s, f.samples, f.a, f.b, f.sigma, f.r);
+            
+            // A fit without error would cut with no margin at all
+            ProbCut::Check c;
+            c.shallow = s;
+            c.a = f.a;
+            c.b = f.b;
+            c.sigma = f.sigma;
+            if (f.samples < 3 || f.sigma <= 0 || !probcut.add(d, c)) {
+                std::printf("      depth %d left without the check of depth %d\n", d, s);
+            }
+        }
+    }
+    
+    if (!probcut.save(output)) {
+        std::fprintf(stderr, "cannot write %s\n", output.c_str());
+        return 1;
+    }
+    std::printf("\nparameters written to %s\n", output.c_str());
+    return 0;
+}
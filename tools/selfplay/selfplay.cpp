@@ -0,0 +1,191 @@
+/* Writes compact game records for tools/train: games of the engine
+ * against itself, each opened by random moves so that no two are alike
+ * and solved exactly near the end so that results are worth learning
+ * from. With -i it converts transcripts, one game per line like
+ * "f5d6c3d3c4f4...", instead of playing.
+ *
+ * usage: selfplay [-n games] [-d depth] [-r random_plies] [-e endgame_empties]
+ *                 [-t threads] [-m hash_mb] [-w weights] [-s seed] -o record_file
+ *        selfplay -i transcript_file -o record_file */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Engine.h"
+#include "GameRecord.h"
+
+using namespace reversi;
+
+namespace {
+
+struct Settings {
+    int games = 1000;
+    int depth = 6;
+    int random_plies = 10;
+    int endgame_empties = 14;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    int hash_mb = 16;
+    unsigned seed = 2018;
+    std::string weights;
+};
+
+// Uniformly random legal move, or -1 if pos has none
+int random_move(const Position& pos, std::mt19937& rng)
+{
+    Bitboard moves = pos.moves();
+    if (!moves) {return -1;}
+    for (int n = rng() % popcount(moves); n > 0; --n) {moves &= moves - 1;}
+    return first_square(moves);
+}
+
+GameRecord play_game(Engine& engine, const Settings& s, const int index)
+{
+    std::mt19937 rng (s.seed + index);
+    
+    SearchLimits limits;
+    limits.depth = s.depth;
+    limits.endgame_empties = s.endgame_empties;
+    
+    GameRecord game;
+    Position pos = Position::initial();
+    engine.new_game();
+    
+    while (true) {
+        if (!pos.has_moves()) {
+            pos = pos.pass();
+            if (!pos.has_moves()) {break;}
+        }
+        
+        const int sq = static_cast<int>(game.moves.size()) < s.random_plies
+                     ? random_move(pos, rng)
+                     : engine.search(pos, limits).move;
+        game.moves.push_back(sq);
+        pos = pos.play(sq);
+    }
+    return game;
+}
+
+int generate(const Settings& s, std::FILE* out)
+{
+    std::atomic<int> next {0};
+    std::mutex out_mutex;
+    std::atomic<bool> failed {false};
+    std::atomic<std::uint64_t> positions {0};
+    
+    const auto start = std::chrono::steady_clock::now();
+    
+    auto worker = [&]() {
+        Engine engine;
+        engine.set_hash_size(s.hash_mb);
+        if (!s.weights.empty()) {engine.load_weights(s.weights);}
+        
+        for (int i = next++; i < s.games && !failed; i = next++) {
+            const GameRecord game = play_game(engine, s, i);
+            positions += game.moves.size();
+            
+            std::lock_guard<std::mutex> lock (out_mutex);
+            if (!write_record(out, game)) {failed = true;}
+            if ((i + 1) % 1000 == 0) {std::fprintf(stderr, "%d games\n", i + 1);}
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (int t=0; t<s.threads; ++t) {pool.emplace_back(worker);}
+    for (auto& th: pool) {th.join();}
+    
+    if (failed) {return -1;}
+    
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%d games, %llu positions in %.1f s (%.1f games/s)\n",
+                s.games, static_cast<unsigned long long>(positions.load()),
+                seconds, s.games / seconds);
+    return s.games;
+}
+
+int convert(const std::string& input, std::FILE* out)
+{
+    std::ifstream in (input);
+    if (!in) {
+        std::fprintf(stderr, "cannot read %s\n", input.c_str());
+        return -1;
+    }
+    
+    std::string line;
+    GameRecord game;
+    int games = 0, rejected = 0;
+    
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {continue;}
+        
+        if (!parse_game(line, game) || !game.is_finished()) {
+            ++rejected;
+            continue;
+        }
+        if (!write_record(out, game)) {return -1;}
+        ++games;
+    }
+    
+    std::printf("%d games converted, %d rejected\n", games, rejected);
+    return games;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Settings s;
+    std::string input, output;
+    
+    for (int i=1; i<argc; ++i) {
+        if (!std::strcmp(argv[i], "-n") && i+1 < argc) {s.games = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-d") && i+1 < argc) {s.depth = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-r") && i+1 < argc) {s.random_plies = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-e") && i+1 < argc) {s.endgame_empties = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-t") && i+1 < argc) {s.threads = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-m") && i+1 < argc) {s.hash_mb = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-w") && i+1 < argc) {s.weights = argv[++i];}
+        else if (!std::strcmp(argv[i], "-s") && i+1 < argc) {s.seed = std::strtoul(argv[++i], nullptr, 10);}
+        else if (!std::strcmp(argv[i], "-i") && i+1 < argc) {input = argv[++i];}
+        else if (!std::strcmp(argv[i], "-o") && i+1 < argc) {output = argv[++i];}
+        else {output.clear(); break;}
+    }
+    
+    if (output.empty() || s.games < 1 || s.depth < 1 || s.threads < 1) {
+        std::fprintf(stderr, "usage: %s [-n games] [-d depth] [-r random_plies] [-e endgame_empties]\n"
+                             "       [-t threads] [-m hash_mb] [-w weights] [-s seed] -o record_file\n"
+                             "       %s -i transcript_file -o record_file\n", argv[0], argv[0]);
+        return 1;
+    }
+    
+    if (!s.weights.empty()) {
+        PatternEvaluator check;
+        if (!check.load(s.weights)) {
+            std::fprintf(stderr, "cannot load weights %s\n", s.weights.c_str());
+            return 1;
+        }
+    }
+    
+    std::FILE* out = std::fopen(output.c_str(), "wb");
+    if (!out) {
+        std::fprintf(stderr, "cannot write %s\n", output.c_str());
+        return 1;
+    }
+    
+    const int games = input.empty() ? generate(s, out) : convert(input, out);
+    
+    if (std::fclose(out) != 0 || games < 0) {
+        std::fprintf(stderr, "cannot write %s\n", output.c_str());
+        return 1;
+    }
+    return 0;
+}
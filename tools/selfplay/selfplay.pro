@@ -0,0 +1,10 @@
+TEMPLATE = app
+TARGET = selfplay
+CONFIG += console release
+CONFIG -= qt app_bundle
+
+SOURCES += selfplay.cpp
+include(../../engine/engine.pri)
+
+QMAKE_CXXFLAGS += -std=c++14 -pthread
+LIBS += -pthread
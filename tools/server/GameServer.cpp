@@ -0,0 +1,410 @@
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+#include "GameRecord.h"
+#include "GameServer.h"
+
+namespace reversi {
+
+WorkStealingPool::WorkStealingPool(const int threads)
+{
+    const int n = std::max(1, threads);
+    for (int i=0; i<n; ++i) {queues.emplace_back(new Queue);}
+    for (int i=0; i<n; ++i) {workers.emplace_back(&WorkStealingPool::loop, this, i);}
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock (sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& w: workers) {w.join();}
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    ++pending;
+    Queue& q = *queues[next++ % queues.size()];
+    {
+        std::lock_guard<std::mutex> lock (q.mutex);
+        q.tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock (sleep_mutex);
+        ++waiting;
+    }
+    wake.notify_one();
+}
+
+void WorkStealingPool::wait_idle()
+{
+    std::unique_lock<std::mutex> lock (idle_mutex);
+    idle.wait(lock, [this]() {return pending.load() == 0;});
+}
+
+// Own queue first, then the others starting from the next worker
+bool WorkStealingPool::take(const int id, Task& task)
+{
+    const int n = size();
+    for (int i=0; i<n; ++i) {
+        Queue& q = *queues[(id + i) % n];
+        std::lock_guard<std::mutex> lock (q.mutex);
+        if (q.tasks.empty()) {continue;}
+        
+        task = std::move(q.tasks.front());
+        q.tasks.pop_front();
+        --waiting;
+        if (i > 0) {++steals;}
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::loop(const int id)
+{
+    for (;;) {
+        Task task;
+        if (take(id, task)) {
+            task(id);
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> lock (idle_mutex);
+                idle.notify_all();
+            }
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> lock (sleep_mutex);
+        wake.wait(lock, [this]() {return waiting.load() > 0 || stopping;});
+        if (stopping && waiting.load() <= 0) {return;}
+    }
+}
+
+GameServer::GameServer(const ServerOptions& options, Output out)
+    : opts{options}, output{std::move(out)}, tt{options.hash_mb}, pool{options.threads}
+{
+    // The workers only start searching once a game asks, after these exist
+    for (int i=0; i<pool.size(); ++i) {
+        searches.emplace_back(new Search(&tt));
+        deadlines.emplace_back(new Deadline);
+    }
+    watchdog = std::thread(&GameServer::watch_deadlines, this);
+}
+
+GameServer::~GameServer()
+{
+    // The searches queued still need the watchdog
+    pool.wait_idle();
+    {
+        std::lock_guard<std::mutex> lock (watch_mutex);
+        closing = true;
+    }
+    watch.notify_one();
+    watchdog.join();
+}
+
+std::size_t GameServer::num_games() const
+{
+    std::lock_guard<std::mutex> lock (games_mutex);
+    return games.size();
+}
+
+void GameServer::handle(const std::string& line)
+{
+    std::istringstream args (line);
+    std::string cmd, id;
+    if (!(args >> cmd)) {return;}
+    
+    if (cmd == "stats") {
+        stats();
+        return;
+    }
+    if (!(args >> id)) {
+        reply("error - missing game id");
+        return;
+    }
+    
+    if (cmd == "new") {new_game(id, args);}
+    else if (cmd == "board") {
+        std::string rest;
+        std::getline(args >> std::ws, rest);
+        set_board(id, rest);
+    }
+    else if (cmd == "play") {
+        std::string move;
+        args >> move;
+        play(id, move);
+    }
+    else if (cmd == "go") {go(id);}
+    else if (cmd == "show") {show(id);}
+    else if (cmd == "end") {end(id);}
+    else {reply("error " + id + " unknown command " + cmd);}
+}
+
+void GameServer::new_game(const std::string& id, std::istringstream& args)
+{
+    auto game = std::make_shared<Game>();
+    game->clock_ms = opts.clock_ms;
+    
+    int clock_ms, depth;
+    if (args >> clock_ms) {
+        if (clock_ms < 0) {
+            reply("error " + id + " negative clock");
+            return;
+        }
+        game->clock_ms = clock_ms;
+        if (args >> depth) {game->depth = std::max(1, std::min(depth, MAX_DEPTH));}
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock (games_mutex);
+        auto old = games.find(id);
+        if (old != games.end()) {
+            if (old->second->searching) {
+                reply("error " + id + " busy");
+                return;
+            }
+            old->second->ended = true;
+        }
+        games[id] = game;
+    }
+    reply("ok " + id);
+}
+
+void GameServer::set_board(const std::string& id, const std::string& rest)
+{
+    Position pos;
+    bool white;
+    if (!parse_board(rest, pos, white)) {
+        reply("error " + id + " not a board");
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock (games_mutex);
+    std::shared_ptr<Game> game = find(id, true);
+    if (!game) {return;}
+    game->pos = pos;
+    game->white_to_move = white;
+    reply("ok " + id);
+}
+
+void GameServer::play(const std::string& id, const std::string& move)
+{
+    std::lock_guard<std::mutex> lock (games_mutex);
+    std::shared_ptr<Game> game = find(id, true);
+    if (!game) {return;}
+    
+    Game& g = *game;
+    if (move == "pass") {
+        if (g.pos.has_moves() || !g.pos.pass().has_moves()) {
+            reply("error " + id + " illegal move " + move);
+            return;
+        }
+        g.pos = g.pos.pass();
+    }
+    else {
+        const int sq = parse_square(move.c_str());
+        if (sq < 0 || !g.pos.is_legal(sq)) {
+            reply("error " + id + " illegal move " + move);
+            return;
+        }
+        g.pos = g.pos.play(sq);
+    }
+    g.white_to_move = !g.white_to_move;
+    
+    reply("ok " + id);
+    const std::string over = game_over(id, g);
+    if (!over.empty()) {reply(over);}
+}
+
+void GameServer::go(const std::string& id)
+{
+    std::lock_guard<std::mutex> lock (games_mutex);
+    std::shared_ptr<Game> game = find(id, true);
+    if (!game) {return;}
+    
+    Game& g = *game;
+    if (!g.pos.has_moves()) {
+        if (!g.pos.pass().has_moves()) {
+            reply("error " + id + " game over");
+            return;
+        }
+        // Nothing to search: the pass is played at once
+        g.pos = g.pos.pass();
+        g.white_to_move = !g.white_to_move;
+        reply("move " + id + " pass 0 0 0 0 " + std::to_string(g.clock_ms));
+        return;
+    }
+    
+    // The time left shared between the moves the engine still has to play, and one
+    // share kept back for the time a stopped search takes to return
+    const int moves_left = (g.pos.num_empties() + 1) / 2 + 1;
+    
+    SearchLimits limits;
+    limits.depth = g.depth;
+    limits.time_ms = g.clock_ms / moves_left;
+    limits.endgame_empties = opts.endgame_empties;
+    limits.patterns = opts.patterns;
+    
+    // Not a millisecond left: one ply, which takes microseconds, and no solve
+    if (limits.time_ms < 1) {
+        limits.depth = 1;
+        limits.time_ms = 0;
+        limits.endgame_empties = 0;
+    }
+    
+    g.searching = true;
+    const Position pos = g.pos;
+    pool.submit([this, id, game, pos, limits](const int worker) {search(id, game, pos, limits, worker);});
+}
+
+void GameServer::search(const std::string& id,
+                        const std::shared_ptr<Game>& game,
+                        const Position pos,
+                        const SearchLimits limits,
+                        const int worker)
+{
+    const Clock::time_point start = Clock::now();
+    Deadline& dl = *deadlines[worker];
+    {
+        std::lock_guard<std::mutex> lock (watch_mutex);
+        dl.stop = false;
+        dl.time = start + std::chrono::milliseconds(limits.time_ms);
+        dl.active = limits.time_ms > 0;
+    }
+    watch.notify_one();
+    
+    SearchLimits stoppable = limits;
+    stoppable.stop = &dl.stop;
+    SearchResult res = searches[worker]->run(pos, stoppable);
+    {
+        std::lock_guard<std::mutex> lock (watch_mutex);
+        dl.active = false;
+    }
+    
+    // Stopped before any move was searched through: one ply takes microseconds
+    if (res.move < 0) {
+        SearchLimits quick;
+        quick.depth = 1;
+        quick.patterns = limits.patterns;
+        const std::uint64_t stopped_nodes = res.nodes;
+        res = searches[worker]->run(pos, quick);
+        res.nodes += stopped_nodes;
+    }
+    const int ms = static_cast<int>(std::chrono::duration<double, std::milli>(Clock::now() - start).count() + 0.5);
+    
+    ++searches_done;
+    nodes += res.nodes;
+    
+    std::string move_reply, over;
+    {
+        std::lock_guard<std::mutex> lock (games_mutex);
+        Game& g = *game;
+        g.searching = false;
+        if (g.ended) {return;}
+        
+        g.pos = g.pos.play(res.move);
+        g.white_to_move = !g.white_to_move;
+        if (g.clock_ms >= 0 && g.clock_ms < ms) {++overruns;}
+        g.clock_ms -= ms;
+        
+        move_reply = "move " + id + " " + square_name(res.move) + " " + std::to_string(res.score) + " " +
+                     std::to_string(res.depth) + " " + std::to_string(res.nodes) + " " +
+                     std::to_string(ms) + " " + std::to_string(g.clock_ms);
+        over = game_over(id, g);
+    }
+    
+    reply(move_reply);
+    if (!over.empty()) {reply(over);}
+}
+
+void GameServer::show(const std::string& id)
+{
+    std::lock_guard<std::mutex> lock (games_mutex);
+    std::shared_ptr<Game> game = find(id, false);
+    if (!game) {return;}
+    reply("board " + id + " " + board_string(game->pos, game->white_to_move) + " " +
+          std::to_string(game->clock_ms));
+}
+
+void GameServer::end(const std::string& id)
+{
+    std::lock_guard<std::mutex> lock (games_mutex);
+    std::shared_ptr<Game> game = find(id, false);
+    if (!game) {return;}
+    
+    // A search still running finds the game ended and keeps its move
+    game->ended = true;
+    games.erase(id);
+    reply("ok " + id);
+}
+
+void GameServer::stats()
+{
+    const std::size_t count = num_games();
+    const TTStats st = tt.stats();
+    
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "stats games %zu searches %llu queued %ld stolen %llu overruns %llu nodes %llu hash_hits %.1f",
+                  count, static_cast<unsigned long long>(searches_done.load()), pool.queued(),
+                  static_cast<unsigned long long>(pool.stolen()), static_cast<unsigned long long>(overruns.load()),
+                  static_cast<unsigned long long>(nodes.load()), 100 * st.hit_rate());
+    reply(buf);
+}
+
+std::shared_ptr<GameServer::Game> GameServer::find(const std::string& id, const bool idle)
+{
+    auto it = games.find(id);
+    if (it == games.end()) {
+        reply("error " + id + " no such game");
+        return nullptr;
+    }
+    if (idle && it->second->searching) {
+        reply("error " + id + " busy");
+        return nullptr;
+    }
+    return it->second;
+}
+
+std::string GameServer::game_over(const std::string& id, const Game& game)
+{
+    if (game.pos.has_moves() || game.pos.pass().has_moves()) {return std::string();}
+    
+    const int mine = popcount(game.pos.player), theirs = popcount(game.pos.opponent);
+    const int black = game.white_to_move ? theirs : mine;
+    const int white = game.white_to_move ? mine : theirs;
+    return "over " + id + " " + std::to_string(black) + " " + std::to_string(white);
+}
+
+void GameServer::reply(const std::string& line)
+{
+    std::lock_guard<std::mutex> lock (output_mutex);
+    output(line);
+}
+
+// Sleeps until the nearest deadline of the searches running and stops those past theirs
+void GameServer::watch_deadlines()
+{
+    std::unique_lock<std::mutex> lock (watch_mutex);
+    while (!closing) {
+        const Clock::time_point now = Clock::now();
+        Clock::time_point next = Clock::time_point::max();
+        
+        for (auto& dl: deadlines) {
+            if (!dl->active) {continue;}
+            if (dl->time <= now) {
+                dl->stop = true;
+                dl->active = false;
+            }
+            else {next = std::min(next, dl->time);}
+        }
+        
+        if (next == Clock::time_point::max()) {watch.wait(lock);}
+        else {watch.wait_until(lock, next);}
+    }
+}
+
+} // namespace reversi
@@ -0,0 +1,192 @@
+#ifndef REVERSI_GAME_SERVER_HEADER
+#define REVERSI_GAME_SERVER_HEADER
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Patterns.h"
+#include "Position.h"
+#include "Search.h"
+#include "TranspositionTable.h"
+
+namespace reversi {
+
+/* Thread pool where each worker has a queue of its own. Tasks are
+ * handed to the queues in turn; a worker runs its own tasks oldest
+ * first and, when it has none, steals the oldest task of another
+ * worker, so long searches queued behind each other don't leave the
+ * other workers idle. Tasks get the index of the worker running them,
+ * for state kept per worker */
+class WorkStealingPool {
+public:
+    using Task = std::function<void(int worker)>;
+    
+    explicit WorkStealingPool(const int threads);
+    
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    
+    // Runs the tasks still queued, then stops the workers
+    ~WorkStealingPool();
+    
+    void submit(Task task);
+    
+    // Until every task submitted has run
+    void wait_idle();
+    
+    int size() const noexcept {return static_cast<int>(workers.size());}
+    long queued() const noexcept {return waiting.load();}
+    std::uint64_t stolen() const noexcept {return steals.load();}
+    
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    
+    void loop(const int id);
+    bool take(const int id, Task& task);
+    
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<unsigned> next {0};
+    
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    std::atomic<long> waiting {0};     // tasks in the queues
+    bool stopping = false;
+    
+    std::mutex idle_mutex;
+    std::condition_variable idle;
+    std::atomic<long> pending {0};     // submitted and not finished
+    
+    std::atomic<std::uint64_t> steals {0};
+};
+
+struct ServerOptions {
+    int threads = 1;
+    std::size_t hash_mb = 256;          // one table for all games
+    int endgame_empties = 12;
+    int clock_ms = 60000;               // thinking time of the engine for a whole game
+    const PatternEvaluator* patterns = nullptr;
+};
+
+/* Plays many games at once behind a line protocol. Each command is one
+ * line, and each reply one line given to the output function, which
+ * may be called from any thread but never from two at once, and must
+ * not call handle() itself:
+ *
+ *   new ID [clock_ms [depth]]   a game from the initial position, Black to move   -> ok ID
+ *   board ID BOARD SIDE         sets the position (see parse_board)               -> ok ID
+ *   play ID MOVE                plays a square like f5, or pass                   -> ok ID
+ *   go ID                       the engine plays for the side to move, later      -> move ID MOVE SCORE DEPTH NODES MS CLOCK
+ *   show ID                                                                       -> board ID BOARD SIDE CLOCK
+ *   end ID                      forgets the game                                  -> ok ID
+ *   stats                       -> stats games N searches N queued N stolen N overruns N nodes N hash_hits PERCENT
+ *
+ * A move that ends the game is followed by "over ID BLACK WHITE", the
+ * discs of each side. Errors are "error ID message".
+ * Searches run on a work stealing pool, one thread per search, and share
+ * one transposition table of fixed size. Each game has a clock: the
+ * engine's total thinking time, of which each search gets the time left
+ * divided by the moves it still has to play plus one kept in reserve, or
+ * a search of one ply when that is under 1 ms. A watchdog stops the
+ * search, exact solves included, when its time is up. Only the search
+ * is charged to the clock, not the time spent waiting for a worker. A
+ * clock that still runs out, by the time a stopped search takes to
+ * return, goes negative and counts as an overrun in stats. A game runs
+ * one search at a time: commands for it are refused while it searches */
+class GameServer {
+public:
+    using Output = std::function<void(const std::string& line)>;
+    
+    GameServer(const ServerOptions& options, Output output);
+    
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+    
+    // Waits for the searches still running
+    ~GameServer();
+    
+    void handle(const std::string& line);
+    
+    // Until no search runs or waits
+    void wait() {pool.wait_idle();}
+    
+    std::size_t num_games() const;
+    
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    struct Game {
+        Position pos = Position::initial();
+        bool white_to_move = false;
+        int clock_ms = 0;  // negative once the engine overran it
+        int depth = MAX_DEPTH;
+        bool searching = false;
+        bool ended = false;
+    };
+    
+    // Stop flag of the search of a worker, raised at its deadline
+    struct Deadline {
+        std::atomic<bool> stop {false};
+        Clock::time_point time;
+        bool active = false;
+    };
+    
+    void new_game(const std::string& id, std::istringstream& args);
+    void set_board(const std::string& id, const std::string& rest);
+    void play(const std::string& id, const std::string& move);
+    void go(const std::string& id);
+    void show(const std::string& id);
+    void end(const std::string& id);
+    void stats();
+    
+    void search(const std::string& id, const std::shared_ptr<Game>& game, const Position pos,
+                const SearchLimits limits, const int worker);
+    
+    // Game id, or nullptr after an error reply. The lock must be held
+    std::shared_ptr<Game> find(const std::string& id, const bool idle);
+    
+    // "over" reply if pos ends the game, empty otherwise
+    static std::string game_over(const std::string& id, const Game& game);
+    
+    void reply(const std::string& line);
+    void watch_deadlines();
+    
+    ServerOptions opts;
+    Output output;
+    std::mutex output_mutex;
+    
+    mutable std::mutex games_mutex;
+    std::unordered_map<std::string, std::shared_ptr<Game>> games;
+    
+    TranspositionTable tt;
+    std::vector<std::unique_ptr<Search>> searches;  // one per worker
+    std::atomic<std::uint64_t> searches_done {0}, nodes {0}, overruns {0};
+    
+    std::vector<std::unique_ptr<Deadline>> deadlines;  // one per worker
+    std::mutex watch_mutex;
+    std::condition_variable watch;
+    bool closing = false;
+    std::thread watchdog;
+    
+    // Last, so that it stops before what its tasks use goes away
+    WorkStealingPool pool;
+};
+
+} // namespace reversi
+
+#endif // REVERSI_GAME_SERVER_HEADER
@@ -0,0 +1,68 @@
+/* Headless engine server: plays any number of games at once for the
+ * clients behind it, reading the commands of GameServer from stdin and
+ * writing its replies to stdout, one per line. Replies to "go" come when
+ * the search ends, so they may arrive after those of later commands.
+ * At the end of the input it waits for the searches still running.
+ *
+ * usage: server [-t threads] [-m hash_mb] [-c clock_ms] [-e endgame_empties] [-w weights]
+ * clock_ms is the default thinking time of the engine for a whole game,
+ * hash_mb the size of the table shared by all games */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "GameServer.h"
+
+using namespace reversi;
+
+int main(int argc, char* argv[])
+{
+    ServerOptions opts;
+    opts.threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string weights;
+    int hash_mb = static_cast<int>(opts.hash_mb);
+    bool ok = true;
+    
+    for (int i=1; i<argc; ++i) {
+        if (!std::strcmp(argv[i], "-t") && i+1 < argc) {opts.threads = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-m") && i+1 < argc) {hash_mb = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-c") && i+1 < argc) {opts.clock_ms = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-e") && i+1 < argc) {opts.endgame_empties = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-w") && i+1 < argc) {weights = argv[++i];}
+        else {ok = false; break;}
+    }
+    
+    if (!ok || opts.threads < 1 || hash_mb < 1 || opts.clock_ms < 0 || opts.endgame_empties < 0) {
+        std::fprintf(stderr, "usage: %s [-t threads] [-m hash_mb] [-c clock_ms] [-e endgame_empties] [-w weights]\n",
+                     argv[0]);
+        return 1;
+    }
+    opts.hash_mb = hash_mb;
+    
+    PatternEvaluator patterns;
+    if (!weights.empty()) {
+        if (!patterns.load(weights)) {
+            std::fprintf(stderr, "cannot load weights %s\n", weights.c_str());
+            return 1;
+        }
+        opts.patterns = &patterns;
+    }
+    
+    GameServer server (opts, [](const std::string& line) {
+        std::fputs(line.c_str(), stdout);
+        std::fputc('\n', stdout);
+        std::fflush(stdout);
+    });
+    
+    std::ios::sync_with_stdio(false);
+    std::string line;
+    while (std::getline(std::cin, line)) {server.handle(line);}
+    
+    server.wait();
+    return 0;
+}
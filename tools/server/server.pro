@@ -0,0 +1,11 @@
+TEMPLATE = app
+TARGET = server
+CONFIG += console release
+CONFIG -= qt app_bundle
+
+SOURCES += server.cpp GameServer.cpp
+HEADERS += GameServer.h
+include(../../engine/engine.pri)
+
+QMAKE_CXXFLAGS += -std=c++14 -pthread
+LIBS += -pthread
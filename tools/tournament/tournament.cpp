@@ -0,0 +1,373 @@
+/* Engine against engine matches for regression testing. Each opening of
+ * a fixed set is played twice, each player taking Black once, and the
+ * games run in parallel with one pair of engines per thread. Prints the
+ * wins, draws and losses of the first player, the Elo difference with
+ * its 95% confidence interval, and the time and nodes each player
+ * spends per move.
+ *
+ * A player is a level of the game (beginner, intermediate, expert) or
+ * a list of settings separated by commas, which may also follow a
+ * level: depth=N, time=MS, endgame=N, patterns, weights=FILE, book=FILE,
+ * probcut=FILE. For instance "expert,weights=new.weights" against "expert".
+ * "mcts" plays by Monte Carlo tree search for time=MS (100 by default)
+ * or playouts=N per move instead.
+ *
+ * usage: tournament [-g games] [-t threads] [-m hash_mb] [-p opening_plies]
+ *                   [-f opening_file] player_a player_b
+ * Openings are all distinct positions after the given plies, in a fixed
+ * order, or the transcripts of opening_file, one per line */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Endgame.h"
+#include "Engine.h"
+#include "GameRecord.h"
+
+using namespace reversi;
+
+namespace {
+
+struct Player {
+    std::string name;
+    bool random = false;  // the beginner level
+    bool mcts = false;
+    std::uint64_t playouts = 0;
+    SearchLimits limits;
+    bool patterns = false;
+    std::string weights;
+    std::string book;
+    std::string probcut;
+};
+
+// The levels of the game, as MainWindow plays them
+bool set_level(const std::string& level, Player& p)
+{
+    p.limits = SearchLimits{};
+    p.random = false;
+    
+    if (level == "beginner") {p.random = true;}
+    else if (level == "intermediate") {p.limits.depth = 3;}
+    else if (level == "expert") {
+        p.limits.depth = 5;
+        p.limits.endgame_empties = DEFAULT_ENDGAME_EMPTIES;
+    }
+    else {return false;}
+    return true;
+}
+
+bool parse_player(const std::string& text, Player& p)
+{
+    p.name = text;
+    set_level("intermediate", p);
+    
+    std::size_t start = 0;
+    while (start <= text.size()) {
+        std::size_t end = text.find(',', start);
+        if (end == std::string::npos) {end = text.size();}
+        const std::string item = text.substr(start, end - start);
+        start = end + 1;
+        
+        const std::size_t eq = item.find('=');
+        const std::string key = item.substr(0, eq);
+        const std::string value = eq == std::string::npos ? "" : item.substr(eq + 1);
+        
+        if (eq == std::string::npos) {
+            if (key == "patterns") {p.patterns = true;}
+            else if (key == "mcts") {p.mcts = true;}
+            else if (!set_level(key, p)) {return false;}
+        }
+        else if (key == "depth") {
+            p.limits.depth = std::atoi(value.c_str());
+            p.limits.time_ms = 0;
+            if (p.limits.depth < 1) {return false;}
+        }
+        else if (key == "time") {
+            p.limits.time_ms = std::atoi(value.c_str());
+            p.limits.depth = MAX_DEPTH;
+            if (p.limits.time_ms < 1) {return false;}
+        }
+        else if (key == "endgame") {p.limits.endgame_empties = std::atoi(value.c_str());}
+        else if (key == "weights") {p.weights = value;}
+        else if (key == "book") {p.book = value;}
+        else if (key == "probcut") {p.probcut = value;}
+        else if (key == "playouts") {
+            p.playouts = std::strtoull(value.c_str(), nullptr, 10);
+            if (p.playouts < 1) {return false;}
+        }
+        else {return false;}
+    }
+    
+    if (p.mcts && p.limits.time_ms == 0 && p.playouts == 0) {p.limits.time_ms = 100;}
+    return true;
+}
+
+bool setup(Engine& engine, const Player& p, const int hash_mb)
+{
+    engine.set_hash_size(hash_mb);
+    engine.set_threads(1, ParallelMode::lazy_smp);
+    engine.set_pattern_evaluation(p.patterns);
+    if (!p.weights.empty() && !engine.load_weights(p.weights)) {return false;}
+    if (!p.book.empty() && !engine.open_book(p.book)) {return false;}
+    if (!p.probcut.empty() && !engine.load_probcut(p.probcut)) {return false;}
+    return true;
+}
+
+// Distinct positions (under symmetry) after plies moves, with the moves leading to each
+void add_openings(const Position& pos, const GameRecord& line, const int plies,
+                  std::map<Position, GameRecord>& found)
+{
+    if (static_cast<int>(line.moves.size()) == plies) {
+        found.emplace(pos.canonical(), line);
+        return;
+    }
+    
+    for (Bitboard moves = pos.moves(); moves; moves &= moves - 1) {
+        GameRecord next = line;
+        next.moves.push_back(first_square(moves));
+        
+        Position child = pos.play(first_square(moves));
+        if (!child.has_moves()) {child = child.pass();}
+        if (child.has_moves()) {add_openings(child, next, plies, found);}
+    }
+}
+
+std::vector<GameRecord> make_openings(const int plies)
+{
+    std::map<Position, GameRecord> found;
+    add_openings(Position::initial(), GameRecord{}, plies, found);
+    
+    std::vector<GameRecord> res;
+    for (const auto& node: found) {res.push_back(node.second);}
+    
+    // Spread the openings used by short matches over the whole set
+    std::shuffle(res.begin(), res.end(), std::mt19937{2018});
+    return res;
+}
+
+bool read_openings(const std::string& name, std::vector<GameRecord>& openings)
+{
+    std::ifstream in (name);
+    if (!in) {return false;}
+    
+    std::string line;
+    GameRecord game;
+    
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {continue;}
+        if (!parse_game(line, game) || game.is_finished()) {
+            std::fprintf(stderr, "skipped opening %s\n", line.c_str());
+            continue;
+        }
+        openings.push_back(game);
+    }
+    return true;
+}
+
+struct MoveStats {
+    std::uint64_t moves = 0;
+    std::uint64_t nodes = 0;
+    double seconds = 0;
+    
+    MoveStats& operator+=(const MoveStats& o) noexcept {
+        moves += o.moves;
+        nodes += o.nodes;
+        seconds += o.seconds;
+        return *this;
+    }
+};
+
+struct Results {
+    int wins = 0, draws = 0, losses = 0;  // of player A
+    MoveStats stats[2];
+};
+
+/* Plays one game from an opening. Returns the final disc difference for
+ * player A, who plays Black if a_black */
+int play_game(Engine* engines[2], const Player* players[2], const GameRecord& opening,
+              const bool a_black, std::mt19937& rng, MoveStats stats[2])
+{
+    bool white_to_move;
+    Position pos = opening.final_position(&white_to_move);
+    
+    // Index in engines[] and players[] of the side to move
+    int side = (white_to_move == a_black) ? 1 : 0;
+    
+    engines[0]->new_game();
+    engines[1]->new_game();
+    
+    while (true) {
+        if (!pos.has_moves()) {
+            pos = pos.pass();
+            side = 1 - side;
+            if (!pos.has_moves()) {break;}
+        }
+        
+        const auto start = std::chrono::steady_clock::now();
+        int sq;
+        
+        if (players[side]->random) {
+            Bitboard moves = pos.moves();
+            for (int n = rng() % popcount(moves); n > 0; --n) {moves &= moves - 1;}
+            sq = first_square(moves);
+        }
+        else if (players[side]->mcts) {
+            sq = engines[side]->monte_carlo(pos, players[side]->limits, players[side]->playouts).move;
+            stats[side].nodes += engines[side]->monte_carlo_stats().playouts;
+        }
+        else {
+            const SearchResult res = engines[side]->play(pos, players[side]->limits);
+            sq = res.move;
+            stats[side].nodes += res.nodes;
+        }
+        
+        stats[side].seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ++stats[side].moves;
+        
+        pos = pos.play(sq);
+        side = 1 - side;
+    }
+    
+    const int score = final_score(pos);
+    return side == 0 ? score : -score;
+}
+
+// Elo difference of a score between 0 and 1
+double elo(double score) noexcept
+{
+    score = std::min(std::max(score, 1e-6), 1 - 1e-6);
+    return -400 * std::log10(1 / score - 1);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int games = 1000;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    int hash_mb = 16;
+    int plies = 8;
+    std::string opening_file;
+    std::vector<std::string> names;
+    
+    for (int i=1; i<argc; ++i) {
+        if (!std::strcmp(argv[i], "-g") && i+1 < argc) {games = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-t") && i+1 < argc) {threads = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-m") && i+1 < argc) {hash_mb = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-p") && i+1 < argc) {plies = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-f") && i+1 < argc) {opening_file = argv[++i];}
+        else if (argv[i][0] != '-') {names.push_back(argv[i]);}
+        else {names.clear(); break;}
+    }
+    
+    Player players[2];
+    
+    if (names.size() != 2 || games < 1 || threads < 1 || plies < 0 ||
+        !parse_player(names[0], players[0]) || !parse_player(names[1], players[1])) {
+        std::fprintf(stderr, "usage: %s [-g games] [-t threads] [-m hash_mb] [-p opening_plies]\n"
+                             "       [-f opening_file] player_a player_b\n"
+                             "players: beginner, intermediate, expert or settings separated by commas:\n"
+                             "         depth=N, time=MS, endgame=N, patterns, weights=FILE, book=FILE,\n"
+                             "         probcut=FILE, mcts, playouts=N\n",
+                     argv[0]);
+        return 1;
+    }
+    
+    for (const auto& p: players) {
+        Engine check;
+        if (!setup(check, p, 1)) {
+            std::fprintf(stderr, "cannot load the weights, book or ProbCut parameters of %s\n", p.name.c_str());
+            return 1;
+        }
+    }
+    
+    std::vector<GameRecord> openings;
+    if (opening_file.empty()) {openings = make_openings(plies);}
+    else if (!read_openings(opening_file, openings)) {
+        std::fprintf(stderr, "cannot read %s\n", opening_file.c_str());
+        return 1;
+    }
+    if (openings.empty()) {
+        std::fprintf(stderr, "no openings\n");
+        return 1;
+    }
+    
+    std::printf("%s against %s: %d games on %d threads, %zu openings\n",
+                players[0].name.c_str(), players[1].name.c_str(), games, threads, openings.size());
+    std::fflush(stdout);
+    
+    Results total;
+    std::mutex total_mutex;
+    std::atomic<int> next {0};
+    
+    const auto start = std::chrono::steady_clock::now();
+    
+    auto worker = [&]() {
+        Engine a, b;
+        setup(a, players[0], hash_mb);
+        setup(b, players[1], hash_mb);
+        Engine* engines[2] = {&a, &b};
+        const Player* p[2] = {&players[0], &players[1]};
+        
+        for (int g = next++; g < games; g = next++) {
+            // Both colours of each opening, in turn
+            std::mt19937 rng (g);
+            MoveStats stats[2];
+            const int score = play_game(engines, p, openings[(g / 2) % openings.size()], g % 2 == 0, rng, stats);
+            
+            std::lock_guard<std::mutex> lock (total_mutex);
+            if (score > 0) {++total.wins;}
+            else if (score < 0) {++total.losses;}
+            else {++total.draws;}
+            total.stats[0] += stats[0];
+            total.stats[1] += stats[1];
+            
+            const int played = total.wins + total.draws + total.losses;
+            if (played % 100 == 0) {
+                std::fprintf(stderr, "%d games: +%d =%d -%d\n", played, total.wins, total.draws, total.losses);
+            }
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (int t=0; t<threads; ++t) {pool.emplace_back(worker);}
+    for (auto& th: pool) {th.join();}
+    
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    // Score of A per game, its standard error and the Elo interval it gives
+    const double n = games;
+    const double score = (total.wins + 0.5 * total.draws) / n;
+    const double variance = (total.wins * (1 - score) * (1 - score) +
+                             total.draws * (0.5 - score) * (0.5 - score) +
+                             total.losses * score * score) / n;
+    const double margin = 1.96 * std::sqrt(variance / n);
+    
+    std::printf("%s: %d wins, %d draws, %d losses, score %.1f%%\n",
+                players[0].name.c_str(), total.wins, total.draws, total.losses, 100 * score);
+    std::printf("Elo difference: %+.1f (95%% interval %+.1f to %+.1f)\n",
+                elo(score), elo(score - margin), elo(score + margin));
+    
+    // Nodes are playouts for Monte Carlo players
+    std::printf("%-30s %10s %12s %14s\n", "player", "moves", "ms/move", "nodes/move");
+    for (int i=0; i<2; ++i) {
+        const MoveStats& st = total.stats[i];
+        const double moves = st.moves ? static_cast<double>(st.moves) : 1;
+        std::printf("%-30s %10llu %12.2f %14.0f\n", players[i].name.c_str(),
+                    static_cast<unsigned long long>(st.moves), 1000 * st.seconds / moves, st.nodes / moves);
+    }
+    std::printf("%.1f s, %.1f games/s\n", seconds, games / seconds);
+    return 0;
+}
@@ -0,0 +1,303 @@
+/* Fits the pattern weights of the engine to the results of recorded games
+ * (compact records written by tools/selfplay). Every position of every
+ * game is a sample whose target is the final disc difference for the
+ * side to move, and the weights of its phase are moved by gradient
+ * descent on the squared error: after each batch every weight used by
+ * the batch moves by the rate times the mean error of the samples using
+ * it. The phases have tables of their own, so the threads split the
+ * phases between them and never update the same weight. The file is
+ * read batch by batch while the previous batch trains, so its size is
+ * not bounded by memory. Prints the error and positions per second of
+ * each epoch and writes a weight file for --weights.
+ *
+ * usage: train [-e epochs] [-b batch] [-l rate] [-t threads] [-w initial_weights]
+ *              -o weights_file record_file */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Endgame.h"
+#include "GameRecord.h"
+#include "Patterns.h"
+
+using namespace reversi;
+
+namespace {
+
+struct Sample {
+    Position pos;
+    float target; // final disc difference for the side to move
+};
+
+// Samples of one batch, by phase
+struct Batch {
+    std::vector<Sample> phases[NUM_PHASES];
+    std::size_t size = 0;
+    
+    void clear() {
+        for (auto& v: phases) {v.clear();}
+        size = 0;
+    }
+};
+
+// Positions of the games of a record file, read as they are needed
+class SampleReader {
+public:
+    explicit SampleReader(std::FILE* file) : f{file} {}
+    
+    // Fills batch with up to count samples. Returns false once the file is exhausted
+    bool fill(Batch& batch, const std::size_t count)
+    {
+        batch.clear();
+        while (batch.size < count) {
+            if (next == samples.size() && !read_game()) {break;}
+            
+            const auto& s = samples[next++];
+            batch.phases[s.first].push_back(s.second);
+            ++batch.size;
+        }
+        return batch.size > 0;
+    }
+    
+    void rewind()
+    {
+        std::rewind(f);
+        samples.clear();
+        next = 0;
+        bad = 0;
+    }
+    
+    // Unfinished games skipped since the last rewind
+    std::uint64_t rejected() const noexcept {return bad;}
+    
+private:
+    bool read_game()
+    {
+        samples.clear();
+        next = 0;
+        
+        while (samples.empty()) {
+            if (!read_record(f, game)) {return false;}
+            if (!game.is_finished()) {
+                ++bad;
+                continue;
+            }
+            
+            bool white_to_move;
+            const int result = final_score(game.final_position(&white_to_move));
+            const int black_result = white_to_move ? -result : result;
+            
+            Position pos = Position::initial();
+            bool white = false;
+            
+            for (auto sq: game.moves) {
+                if (!pos.is_legal(sq)) {
+                    pos = pos.pass();
+                    white = !white;
+                }
+                
+                Sample s {pos, static_cast<float>(white ? -black_result : black_result)};
+                samples.emplace_back(PatternEvaluator::phase(pos), s);
+                
+                pos = pos.play(sq);
+                white = !white;
+            }
+        }
+        return true;
+    }
+    
+    std::FILE* f;
+    GameRecord game;
+    std::vector<std::pair<int, Sample>> samples; // of the current game
+    std::size_t next = 0;
+    std::uint64_t bad = 0;
+};
+
+/* Weights in discs, as floats while training, with the gradient of the
+ * batch of each phase */
+class Trainer {
+public:
+    Trainer(const PatternEvaluator& initial, const float learning_rate)
+        : size{static_cast<std::size_t>(PatternEvaluator::table_size())},
+          rate{learning_rate},
+          weights(NUM_PHASES * size),
+          gradient(NUM_PHASES * size, 0),
+          count(NUM_PHASES * size, 0)
+    {
+        for (int ph=0; ph<NUM_PHASES; ++ph) {
+            for (std::size_t i=0; i<size; ++i) {
+                weights[ph * size + i] = static_cast<float>(initial.table(ph)[i]) / PATTERN_SCALE;
+            }
+        }
+    }
+    
+    /* Trains on the samples of one phase, with room for their features in
+     * offsets. Returns their squared error before the update */
+    double train(const int ph, const std::vector<Sample>& samples, std::vector<std::int32_t>& offsets)
+    {
+        float* w = &weights[ph * size];
+        float* g = &gradient[ph * size];
+        std::uint32_t* n = &count[ph * size];
+        double sse = 0;
+        
+        offsets.resize(samples.size() * NUM_FEATURES);
+        
+        for (std::size_t k=0; k<samples.size(); ++k) {
+            std::int32_t* o = &offsets[k * NUM_FEATURES];
+            PatternEvaluator::features(samples[k].pos, o);
+            
+            float score = 0;
+            for (int f=0; f<NUM_FEATURES; ++f) {score += w[o[f]];}
+            
+            const float err = samples[k].target - score;
+            sse += static_cast<double>(err) * err;
+            
+            for (int f=0; f<NUM_FEATURES; ++f) {
+                g[o[f]] += err;
+                ++n[o[f]];
+            }
+        }
+        
+        // Only the weights the samples used have a gradient to apply and clear
+        for (auto i: offsets) {
+            if (n[i]) {
+                w[i] += rate * g[i] / n[i];
+                g[i] = 0;
+                n[i] = 0;
+            }
+        }
+        return sse;
+    }
+    
+    // Rounded to the fixed point weights of the engine
+    void store(PatternEvaluator& ev) const noexcept
+    {
+        const float bound = 32767;
+        for (int ph=0; ph<NUM_PHASES; ++ph) {
+            for (std::size_t i=0; i<size; ++i) {
+                const float v = std::max(-bound, std::min(bound, weights[ph * size + i] * PATTERN_SCALE));
+                ev.table(ph)[i] = static_cast<std::int16_t>(std::lround(v));
+            }
+        }
+    }
+    
+private:
+    std::size_t size;
+    float rate;
+    std::vector<float> weights;
+    std::vector<float> gradient;
+    std::vector<std::uint32_t> count;
+};
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int epochs = 10;
+    int batch_size = 65536;
+    float rate = 0.01f;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string initial, output, input;
+    
+    for (int i=1; i<argc; ++i) {
+        if (!std::strcmp(argv[i], "-e") && i+1 < argc) {epochs = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-b") && i+1 < argc) {batch_size = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-l") && i+1 < argc) {rate = static_cast<float>(std::atof(argv[++i]));}
+        else if (!std::strcmp(argv[i], "-t") && i+1 < argc) {threads = std::atoi(argv[++i]);}
+        else if (!std::strcmp(argv[i], "-w") && i+1 < argc) {initial = argv[++i];}
+        else if (!std::strcmp(argv[i], "-o") && i+1 < argc) {output = argv[++i];}
+        else if (argv[i][0] != '-' && input.empty()) {input = argv[i];}
+        else {output.clear(); break;}
+    }
+    
+    if (output.empty() || input.empty() || epochs < 1 || batch_size < 1 || threads < 1 || rate <= 0) {
+        std::fprintf(stderr, "usage: %s [-e epochs] [-b batch] [-l rate] [-t threads] [-w initial_weights]\n"
+                             "       -o weights_file record_file\n", argv[0]);
+        return 1;
+    }
+    
+    // More threads than phases would have nothing to do
+    threads = std::min(threads, NUM_PHASES);
+    
+    PatternEvaluator ev;
+    if (!initial.empty() && !ev.load(initial)) {
+        std::fprintf(stderr, "cannot load weights %s\n", initial.c_str());
+        return 1;
+    }
+    
+    std::FILE* f = std::fopen(input.c_str(), "rb");
+    if (!f) {
+        std::fprintf(stderr, "cannot read %s\n", input.c_str());
+        return 1;
+    }
+    
+    Trainer trainer (ev, rate);
+    SampleReader reader (f);
+    Batch batches[2];
+    std::vector<std::vector<std::int32_t>> offsets (threads);
+    
+    for (int epoch=1; epoch<=epochs; ++epoch) {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<double> sse (threads, 0);
+        std::uint64_t positions = 0;
+        
+        reader.rewind();
+        int cur = 0;
+        bool more = reader.fill(batches[cur], batch_size);
+        
+        while (more) {
+            const Batch& batch = batches[cur];
+            positions += batch.size;
+            
+            std::vector<std::thread> pool;
+            for (int t=0; t<threads; ++t) {
+                pool.emplace_back([&, t]() {
+                    for (int ph=t; ph<NUM_PHASES; ph+=threads) {
+                        sse[t] += trainer.train(ph, batch.phases[ph], offsets[t]);
+                    }
+                });
+            }
+            
+            // The next batch is read while this one trains
+            cur = 1 - cur;
+            more = reader.fill(batches[cur], batch_size);
+            
+            for (auto& th: pool) {th.join();}
+        }
+        
+        if (!positions) {
+            std::fprintf(stderr, "no games in %s\n", input.c_str());
+            std::fclose(f);
+            return 1;
+        }
+        
+        double total = 0;
+        for (auto e: sse) {total += e;}
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        std::printf("epoch %2d: %llu positions, rms error %.2f discs, %.1f s, %.2f M positions/s\n",
+                    epoch, static_cast<unsigned long long>(positions),
+                    std::sqrt(total / positions), seconds, positions / seconds / 1e6);
+        std::fflush(stdout);
+    }
+    std::fclose(f);
+    
+    if (reader.rejected()) {
+        std::printf("%llu unfinished games skipped\n", static_cast<unsigned long long>(reader.rejected()));
+    }
+    
+    trainer.store(ev);
+    if (!ev.save(output)) {
+        std::fprintf(stderr, "cannot write %s\n", output.c_str());
+        return 1;
+    }
+    std::printf("weights written to %s\n", output.c_str());
+    return 0;
+}